@@ -87,6 +87,14 @@ typedef struct ff_face_s
     FT_UInt horz_res;
     FT_UInt vert_res;
 
+    /* The gs_fapi_font_scale values the above were derived from, so that
+     * repeated requests for the same scale (one per glyph) do not reset the
+     * FreeType size, which for hinted TrueType re-runs the 'prep' program.
+     */
+    bool scale_valid;
+    fracint scale_matrix[4];
+    fracint scale_HWResolution[2];
+
     /* If non-null, the incremental interface object passed to FreeType. */
     FT_Incremental_InterfaceRec *ft_inc_int;
     /* If non-null, we're using a custom stream object for Freetype to read the font file */
@@ -203,6 +211,7 @@ FF_open_read_stream(gs_memory_t * mem, char *fname, FT_Stream * fts)
     gs_parsed_file_name_t pfn;
     stream *ps = (stream *)NULL;
     gs_offset_t length;
+    const byte *data;
     FT_Stream ftstrm = NULL;
 
     code = gs_parse_file_name(&pfn, (const char *)fname, strlen(fname), mem);
@@ -255,9 +264,21 @@ FF_open_read_stream(gs_memory_t * mem, char *fname, FT_Stream * fts)
     }
     memset(ftstrm, 0x00, sizeof(FT_StreamRec));
 
-    ftstrm->descriptor.pointer = ps;
-    ftstrm->read = FF_stream_read;
-    ftstrm->close = FF_stream_close;
+    if (romfs_file_data(ps, &data, &length)) {
+        /* An uncompressed %rom% file: let FreeType read the read only
+         * image directly (a memory based FT_Stream has no read proc), so
+         * that all instances share the same pages rather than each
+         * copying the font through its own stream buffer.
+         */
+        (void)sclose(ps);
+        ps = NULL;
+        ftstrm->base = (unsigned char *)data;
+    }
+    else {
+        ftstrm->descriptor.pointer = ps;
+        ftstrm->read = FF_stream_read;
+        ftstrm->close = FF_stream_close;
+    }
     ftstrm->size = (long)length;
     *fts = ftstrm;
 
@@ -289,6 +310,7 @@ new_face(gs_fapi_server * a_server, FT_Face a_ft_face,
         face->data_owned = data_owned;
         face->ftstrm = ftstrm;
         face->server = (ff_server *) a_server;
+        face->scale_valid = false;
     }
     return face;
 }
@@ -1319,7 +1341,16 @@ gs_fapi_ft_get_scaled_font(gs_fapi_server * a_server, gs_fapi_font * a_font,
      * The matrix is scaled by the shift specified in the server, 16,
      * so we divide by 65536 when converting to a gs_matrix.
      */
-    if (face) {
+    if (face && face->scale_valid
+        && !memcmp(face->scale_matrix, a_font_scale->matrix,
+                   sizeof(face->scale_matrix))
+        && !memcmp(face->scale_HWResolution, a_font_scale->HWResolution,
+                   sizeof(face->scale_HWResolution))) {
+        /* The size and transform in force are already the ones requested. */
+    }
+    else if (face) {
+        face->scale_valid = false;
+
         /* Convert the GS transform into an FT transform.
          * Ignore the translation elements because they contain very large values
          * derived from the current transformation matrix and so are of no use.
@@ -1357,7 +1388,15 @@ gs_fapi_ft_get_scaled_font(gs_fapi_server * a_server, gs_fapi_font * a_font,
          */
 
         FT_Set_Transform(face->ft_face, &face->ft_transform, NULL);
-        
+
+        memcpy(face->scale_matrix, a_font_scale->matrix,
+               sizeof(face->scale_matrix));
+        memcpy(face->scale_HWResolution, a_font_scale->HWResolution,
+               sizeof(face->scale_HWResolution));
+        face->scale_valid = true;
+    }
+
+    if (face) {
         if (!a_font->is_type1) {
             for (i = 0; i < GS_FAPI_NUM_TTF_CMAP_REQ && !cmap; i++) {
                 if (a_font->ttf_cmap_req[i].platform_id > 0) {
@@ -1797,6 +1836,7 @@ gs_fapi_ft_set_mm_weight_vector(gs_fapi_server *server, gs_fapi_font *ff, float
     
     if (setit == true) {
         ft_error = FT_Set_MM_WeightVector(face->ft_face, length, nwv);
+        face->scale_valid = false;
         if (ft_error != 0) return_error(gs_error_invalidaccess);
     }
 
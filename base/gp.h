@@ -120,6 +120,27 @@ void gp_get_realtime(long *ptm);
  */
 void gp_get_usertime(long *ptm);
 
+/* ------ Worker processes ------ */
+
+/*
+ * Start a copy of the current process, as Unix fork() does.  Return 0 in
+ * the copy, the (positive) process id of the copy in the original, or a
+ * negative value if this platform can't copy processes.
+ */
+int gp_fork_process(void);
+
+/*
+ * Wait for a process started by gp_fork_process to end, and return its
+ * exit status, or a negative value if that can't be determined.
+ */
+int gp_wait_process(int pid);
+
+/*
+ * End a process started by gp_fork_process immediately, without the
+ * cleanup that gp_do_exit does on behalf of the original.
+ */
+void gp_exit_process(int exit_status);
+
 /* ------ Reading lines from stdin ------ */
 
 /*
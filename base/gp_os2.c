@@ -138,6 +138,27 @@ gp_get_usertime(long *pdt)
     gp_get_realtime(pdt);	/* Use an approximation for now.  */
 }
 
+/* ------ Worker processes ------ */
+
+/* We can't copy processes on this platform. */
+int
+gp_fork_process(void)
+{
+    return -1;
+}
+
+int
+gp_wait_process(int pid)
+{
+    return -1;
+}
+
+void
+gp_exit_process(int exit_status)
+{
+    gp_do_exit(exit_status);
+}
+
 /* ------ Console management ------ */
 
 /* Answer whether a given file is the console (input or output). */
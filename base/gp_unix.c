@@ -19,10 +19,14 @@
 #include "pipe_.h"
 #include "string_.h"
 #include "time_.h"
+#include "unistd_.h"
+#include "errno_.h"
 #include "gx.h"
 #include "gsexit.h"
 #include "gp.h"
 
+#include <sys/wait.h>
+
 #ifdef HAVE_FONTCONFIG
 #  include <fontconfig/fontconfig.h>
 #endif
@@ -196,6 +200,33 @@ gp_get_usertime(long *pdt)
 #endif
 }
 
+/* ------ Worker processes ------ */
+
+int
+gp_fork_process(void)
+{
+    pid_t pid = fork();
+
+    return (pid < 0 ? -1 : (int)pid);
+}
+
+int
+gp_wait_process(int pid)
+{
+    int status;
+
+    while (waitpid((pid_t)pid, &status, 0) < 0)
+        if (errno != EINTR)
+            return -1;
+    return (WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+}
+
+void
+gp_exit_process(int exit_status)
+{
+    _exit(exit_status);
+}
+
 /* ------ Screen management ------ */
 
 /* Get the environment variable that specifies the display to use. */
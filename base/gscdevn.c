@@ -159,11 +159,47 @@ alloc_device_n_map(gs_device_n_map ** ppmap, gs_memory_t * mem,
                       return_error(gs_error_VMerror), cname);
     pimap->tint_transform = 0;
     pimap->tint_transform_data = 0;
-    pimap->cache_valid = false;
+    pimap->cache_valid = 0;
     *ppmap = pimap;
     return 0;
 }
 
+/* Run a tint transform, using the map's cache. */
+int
+gx_device_n_map_tint_transform(gs_device_n_map *pmap, const float *in,
+                               int num_in, float *out, int num_out,
+                               const gs_gstate *pgs)
+{
+    uint hash = 0;
+    float *entry;
+    int i, code;
+
+    if (num_in + num_out > DEVICE_N_MAP_CACHE_MAX_VALUES)
+        return (*pmap->tint_transform)(in, out, pgs,
+                                       pmap->tint_transform_data);
+    for (i = 0; i < num_in; ++i) {
+        uint32_t bits;
+
+        memcpy(&bits, &in[i], sizeof(bits));
+        hash = (hash ^ bits) * 0x9e3779b1;
+    }
+    hash = (hash >> 16) & (DEVICE_N_MAP_CACHE_SIZE - 1);
+    entry = pmap->cache[hash];
+    if ((pmap->cache_valid & (1 << hash)) &&
+        !memcmp(entry, in, num_in * sizeof(float))) {
+        memcpy(out, entry + num_in, num_out * sizeof(float));
+        return 0;
+    }
+    code = (*pmap->tint_transform)(in, out, pgs, pmap->tint_transform_data);
+    /* Don't cache errors or the interpreter's special return codes. */
+    if (code == 0) {
+        memcpy(entry, in, num_in * sizeof(float));
+        memcpy(entry + num_in, out, num_out * sizeof(float));
+        pmap->cache_valid |= 1 << hash;
+    }
+    return code;
+}
+
 /*
  * DeviceN and NChannel color spaces can have an attributes dict.  In the
  * attribute dict can be a Colorants dict which contains Separation color
@@ -225,7 +261,7 @@ gs_cspace_set_devn_proc(gs_color_space * pcspace,
     pimap = pcspace->params.device_n.map;
     pimap->tint_transform = proc;
     pimap->tint_transform_data = proc_data;
-    pimap->cache_valid = false;
+    pimap->cache_valid = 0;
     return 0;
 }
 #endif
@@ -266,7 +302,7 @@ gs_cspace_set_devn_function(gs_color_space *pcspace, gs_function_t *pfn)
     pimap = pcspace->params.device_n.map;
     pimap->tint_transform = map_devn_using_function;
     pimap->tint_transform_data = pfn;
-    pimap->cache_valid = false;
+    pimap->cache_valid = 0;
     return 0;
 }
 
@@ -439,25 +475,9 @@ gx_concretize_DeviceN(const gs_client_color * pc, const gs_color_space * pcs,
      */
 
     if (pgs->color_component_map.use_alt_cspace) {
-        /* Check the 1-element cache first. */
-        if (map->cache_valid) {
-            int i;
-
-            for (i = pcs->params.device_n.num_components; --i >= 0;) {
-                if (map->tint[i] != pc->paint.values[i])
-                    break;
-            }
-            if (i < 0) {
-                int num_out = gs_color_space_num_components(pacs);
-
-                for (i = 0; i < num_out; ++i)
-                    pconc[i] = map->conc[i];
-                return 0;
-            }
-        }
-        tcode = (*pcs->params.device_n.map->tint_transform)
-             (pc->paint.values, &cc.paint.values[0],
-             pgs, pcs->params.device_n.map->tint_transform_data);
+        tcode = gx_device_n_map_tint_transform(map, pc->paint.values,
+                    num_src_comps, &cc.paint.values[0],
+                    gs_color_space_num_components(pacs), pgs);
         (*pacs->type->restrict_color)(&cc, pacs);
         if (tcode < 0)
             return tcode;
@@ -275,7 +275,7 @@ gs_cspace_set_sepr_proc(gs_color_space * pcspace,
     pimap = pcspace->params.separation.map;
     pimap->tint_transform = proc;
     pimap->tint_transform_data = proc_data;
-    pimap->cache_valid = false;
+    pimap->cache_valid = 0;
 
     return 0;
 }
@@ -297,7 +297,7 @@ gs_cspace_set_sepr_function(const gs_color_space *pcspace, gs_function_t *pfn)
     pimap = pcspace->params.separation.map;
     pimap->tint_transform = map_devn_using_function;
     pimap->tint_transform_data = pfn;
-    pimap->cache_valid = false;
+    pimap->cache_valid = 0;
     return 0;
 }
 
@@ -367,17 +367,10 @@ gx_concretize_Separation(const gs_client_color *pc, const gs_color_space *pcs,
     if (pcs->params.separation.sep_type == SEP_OTHER &&
         pcs->params.separation.use_alt_cspace) {
         gs_device_n_map *map = pcs->params.separation.map;
-        /* Check the 1-element cache first. */
-        if (map->cache_valid && map->tint[0] == pc->paint.values[0]) {
-            int i, num_out = gs_color_space_num_components(pacs);
 
-            for (i = 0; i < num_out; ++i)
-                pconc[i] = map->conc[i];
-            return 0;
-        }
-        code = (*pcs->params.separation.map->tint_transform)
-            (pc->paint.values, &cc.paint.values[0],
-             pgs, pcs->params.separation.map->tint_transform_data);
+        code = gx_device_n_map_tint_transform(map, pc->paint.values, 1,
+                    &cc.paint.values[0], gs_color_space_num_components(pacs),
+                    pgs);
         if (code < 0)
             return code;
         (*pacs->type->restrict_color)(&cc, pacs);
@@ -166,8 +166,14 @@ code_map_decode_next_multidim_regime(const gx_code_map_t * pcmap,
      * merge and sort keys in 'zbuildcmap', then use binary search here.
      * This would be valuable for UniJIS-UTF8-H, which contains about 7000
      * keys.
+     *
+     * If the map has a first-byte index, only visit the lookup ranges
+     * that can start with str[0]; the others can neither match nor
+     * partially match, so skipping them doesn't change the result.
      */
-    int i;
+    const int *order = NULL;
+    int n = pcmap->num_lookup;
+    int i, t;
 
     /*
      * In the fallback of CMap decoding procedure, there is "partial matching".
@@ -193,15 +199,25 @@ code_map_decode_next_multidim_regime(const gx_code_map_t * pcmap,
 #endif
 #endif
 
-    for (i = pcmap->num_lookup - 1; i >= 0; --i) {
+    if (pcmap->index != NULL && ssize > 0) {
+        order = pcmap->index + 257 + pcmap->index[str[0]];
+        n = pcmap->index[str[0] + 1] - pcmap->index[str[0]];
+    }
+
+    for (t = 0; t < n; ++t) {
         /* main loop - scan the map passed via pcmap */
         /* reverse scan order due to 'usecmap' */
 
-        const gx_cmap_lookup_range_t *pclr = &pcmap->lookup[i];
-        int pre_size = pclr->key_prefix_size, key_size = pclr->key_size,
-            chr_size = pre_size + key_size;
+        const gx_cmap_lookup_range_t *pclr;
+        int pre_size, key_size, chr_size;
 
         int j = 0;
+
+        i = (order != NULL ? order[t] : pcmap->num_lookup - 1 - t);
+        pclr = &pcmap->lookup[i];
+        pre_size = pclr->key_prefix_size;
+        key_size = pclr->key_size;
+        chr_size = pre_size + key_size;
         /* length of the given byte stream is shorter than
          * chr-length of current range, no need for further check,
          * skip to the next range.
@@ -630,8 +646,87 @@ gs_cmap_adobe1_alloc(gs_cmap_adobe1_t **ppcmap, int wmode,
     }
     pcmap1->def.lookup = lookups;
     pcmap1->def.num_lookup = num_lookups;
+    pcmap1->def.index = 0;
     pcmap1->notdef.lookup = 0;
     pcmap1->notdef.num_lookup = 0;
+    pcmap1->notdef.index = 0;
     /* no mark_glyph, mark_glyph_data, glyph_name, glyph_name_data */
     return 0;
 }
+
+/*
+ * Mark the first bytes of the codes that a lookup range can match,
+ * fully or partially, in covers[256].
+ */
+static void
+lookup_range_first_bytes(const gx_cmap_lookup_range_t *pclr, byte *covers)
+{
+    memset(covers, 0, 256);
+    if (pclr->key_prefix_size > 0)
+        covers[pclr->key_prefix[0]] = 1;
+    else if (pclr->key_size == 0)
+        memset(covers, 1, 256);
+    else {
+        int step = pclr->key_size * (pclr->key_is_range ? 2 : 1);
+        const byte *key = pclr->keys.data;
+        int k;
+
+        for (k = 0; k < pclr->num_entries; ++k, key += step) {
+            int lo = key[0], hi = key[step - pclr->key_size];
+
+            if (lo <= hi)
+                memset(covers + lo, 1, hi - lo + 1);
+        }
+    }
+}
+
+/* Build the first-byte index of a code map. */
+static int
+code_map_build_index(gx_code_map_t *pcm, gs_memory_t *mem)
+{
+    byte covers[256];
+    int counts[256];
+    int *index;
+    int total = 0;
+    int b, i;
+
+    gs_free_object(mem, pcm->index, "code_map_build_index");
+    pcm->index = 0;
+    if (pcm->num_lookup == 0)
+        return 0;
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < pcm->num_lookup; ++i) {
+        lookup_range_first_bytes(&pcm->lookup[i], covers);
+        for (b = 0; b < 256; ++b)
+            counts[b] += covers[b];
+    }
+    for (b = 0; b < 256; ++b)
+        total += counts[b];
+    index = (int *)gs_alloc_byte_array(mem, 257 + total, sizeof(int),
+                                       "code_map_build_index");
+    if (index == 0)
+        return_error(gs_error_VMerror);
+    index[0] = 0;
+    for (b = 0; b < 256; ++b)
+        index[b + 1] = index[b] + counts[b];
+    /* Fill each bucket in scan order, i.e. last lookup range first. */
+    memset(counts, 0, sizeof(counts));
+    for (i = pcm->num_lookup - 1; i >= 0; --i) {
+        lookup_range_first_bytes(&pcm->lookup[i], covers);
+        for (b = 0; b < 256; ++b)
+            if (covers[b])
+                index[257 + index[b] + counts[b]++] = i;
+    }
+    pcm->index = index;
+    return 0;
+}
+
+int
+gs_cmap_adobe1_build_index(gs_cmap_adobe1_t *pcmap, gs_memory_t *mem)
+{
+    int code = code_map_build_index(&pcmap->def, mem);
+
+    if (code >= 0)
+        code = code_map_build_index(&pcmap->notdef, mem);
+    return code;
+}
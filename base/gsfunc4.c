@@ -34,6 +34,7 @@ typedef struct gs_function_PtCr_s {
     gs_function_PtCr_params_t params;
     /* Define a bogus DataSource for get_function_info. */
     gs_data_source_t data_source;
+    byte *compiled;		/* calc_program_t, see fn_PtCr_compile */
 } gs_function_PtCr_t;
 
 /* GC descriptor */
@@ -568,6 +569,477 @@ fn_PtCr_evaluate(const gs_function_t *pfn_common, const float *in, float *out)
     return 0;
 }
 
+/* ---------------- Compiled evaluation ---------------- */
+
+/*
+ * Programs without control flow whose run-time values are all numbers,
+ * which covers most DeviceN tint transforms, are compiled once into a
+ * straight-line list of float operations on registers.  The operand
+ * stack is resolved at compile time: stack operators only rearrange
+ * register numbers, and operators whose operands are all constants are
+ * folded.  Anything else is left to fn_PtCr_evaluate, which also reports
+ * any errors.
+ */
+
+/* Define the maximum number of registers of a compiled program. */
+#define MAX_CALC_REGS 256
+
+typedef struct calc_insn_s {
+    byte op;			/* gs_PtCr_opcode_t */
+    ushort dst, a, b;		/* b is unused for 1-operand operators */
+} calc_insn_t;
+
+/*
+ * The compiled program is a single byte object holding no pointers: the
+ * header is followed by the constants, the instructions, and the output
+ * register numbers.  Registers 0 .. m-1 hold the inputs, the next
+ * num_consts the constants, and the rest intermediate results.
+ */
+typedef struct calc_program_s {
+    int num_consts;
+    int num_insns;
+    int num_regs;
+} calc_program_t;
+#define calc_program_consts(pcp)\
+  ((const float *)((const byte *)(pcp) + sizeof(calc_program_t)))
+#define calc_program_insns(pcp)\
+  ((const calc_insn_t *)(calc_program_consts(pcp) + (pcp)->num_consts))
+#define calc_program_outputs(pcp)\
+  ((const ushort *)(calc_program_insns(pcp) + (pcp)->num_insns))
+
+/* Apply a floating point operator.  This is used both for constant */
+/* folding and for evaluation, and must match fn_PtCr_evaluate. */
+static inline int
+calc_float_op(int op, float a, float b, float *pr)
+{
+    switch (op) {
+    case PtCr_abs:
+        *pr = fabs(a); break;
+    case PtCr_ceiling:
+        *pr = ceil(a); break;
+    case PtCr_cos:
+        *pr = gs_cos_degrees(a); break;
+    case PtCr_floor:
+        *pr = floor(a); break;
+    case PtCr_ln:
+        *pr = log(a); break;
+    case PtCr_log:
+        *pr = log10(a); break;
+    case PtCr_neg:
+        *pr = -a; break;
+    case PtCr_round:
+        *pr = floor(a + 0.5); break;
+    case PtCr_sin:
+        *pr = gs_sin_degrees(a); break;
+    case PtCr_sqrt:
+        *pr = sqrt(a); break;
+    case PtCr_truncate:
+        *pr = (a < 0 ? ceil(a) : floor(a)); break;
+    case PtCr_add:
+        *pr = a + b; break;
+    case PtCr_sub:
+        *pr = a - b; break;
+    case PtCr_mul:
+        *pr = a * b; break;
+    case PtCr_div:
+        if (b == 0)
+            return_error(gs_error_undefinedresult);
+        *pr = a / b; break;
+    case PtCr_exp:
+        *pr = pow(a, b); break;
+    case PtCr_atan: {
+        double result;
+        int code = gs_atan2_degrees(a, b, &result);
+
+        if (code < 0)
+            return code;
+        *pr = result;
+        break;
+    }
+    default:
+        return_error(gs_error_unregistered);
+    }
+    return 0;
+}
+
+/* Evaluate a compiled PostScript Calculator function. */
+static int
+fn_PtCr_evaluate_compiled(const gs_function_t *pfn_common, const float *in,
+                          float *out)
+{
+    const gs_function_PtCr_t *pfn = (const gs_function_PtCr_t *)pfn_common;
+    const calc_program_t *pcp = (const calc_program_t *)pfn->compiled;
+    const calc_insn_t *pi = calc_program_insns(pcp);
+    const calc_insn_t *pe = pi + pcp->num_insns;
+    const ushort *outputs = calc_program_outputs(pcp);
+    int m = pfn->params.m;
+    float regs[MAX_CALC_REGS];
+    int code, i;
+
+    memcpy(regs, in, m * sizeof(float));
+    memcpy(regs + m, calc_program_consts(pcp),
+           pcp->num_consts * sizeof(float));
+    for (; pi < pe; ++pi) {
+        code = calc_float_op(pi->op, regs[pi->a], regs[pi->b],
+                             &regs[pi->dst]);
+        if (code < 0)
+            return code;
+    }
+    for (i = 0; i < pfn->params.n; ++i)
+        out[i] = regs[outputs[i]];
+    return 0;
+}
+
+/*
+ * Define the compile-time operand stack.  While compiling, constants are
+ * numbered from MAX_CALC_REGS and intermediate results from
+ * 2 * MAX_CALC_REGS; they are renumbered once the counts are known.
+ */
+typedef struct calc_operand_s {
+    int reg;			/* register, or -1 for a constant */
+    calc_value_t value;		/* the constant */
+} calc_operand_t;
+typedef struct calc_compile_state_s {
+    calc_operand_t stack[MAX_VSTACK + 1];
+    int depth;
+    float consts[MAX_CALC_REGS];
+    int num_consts;
+    calc_insn_t insns[MAX_CALC_REGS];
+    int insn_regs[MAX_CALC_REGS][3];
+    int num_insns;
+} calc_compile_state_t;
+
+/* Return the register holding a numeric operand, or -1 if none is left. */
+static int
+calc_operand_reg(calc_compile_state_t *pcs, const calc_operand_t *pop)
+{
+    if (pop->reg >= 0)
+        return pop->reg;
+    if (pcs->num_consts == MAX_CALC_REGS)
+        return -1;
+    pcs->consts[pcs->num_consts] =
+        (pop->value.type == CVT_INT ? (float)pop->value.value.i :
+         pop->value.value.f);
+    return MAX_CALC_REGS + pcs->num_consts++;
+}
+
+/* Emit an operation on 1 or 2 operands, replacing them on the stack. */
+static bool
+calc_emit(calc_compile_state_t *pcs, int op, int nargs)
+{
+    calc_operand_t *args = &pcs->stack[pcs->depth - nargs];
+    int a = calc_operand_reg(pcs, &args[0]);
+    int b = (nargs == 1 ? a : calc_operand_reg(pcs, &args[1]));
+
+    if (a < 0 || b < 0 || pcs->num_insns == MAX_CALC_REGS)
+        return false;
+    pcs->insns[pcs->num_insns].op = op;
+    pcs->insn_regs[pcs->num_insns][0] = 2 * MAX_CALC_REGS + pcs->num_insns;
+    pcs->insn_regs[pcs->num_insns][1] = a;
+    pcs->insn_regs[pcs->num_insns][2] = b;
+    args[0].reg = 2 * MAX_CALC_REGS + pcs->num_insns++;
+    pcs->depth -= nargs - 1;
+    return true;
+}
+
+/* Compile a 1-operand operator. */
+static bool
+calc_compile_op1(calc_compile_state_t *pcs, int op)
+{
+    calc_operand_t *pop;
+    calc_value_t *pv;
+    float f;
+
+    if (pcs->depth < 1)
+        return false;
+    pop = &pcs->stack[pcs->depth - 1];
+    pv = &pop->value;
+    if (pop->reg >= 0) {
+        /* A run-time value is always a float. */
+        switch (op) {
+        case PtCr_cvr:
+            return true;
+        case PtCr_cvi: case PtCr_not:
+            return false;
+        }
+        return calc_emit(pcs, op, 1);
+    }
+    switch (pv->type) {
+    case CVT_INT:
+        switch (op) {
+        case PtCr_abs:
+            if (pv->value.i >= 0)
+                return true;
+            /* falls through */
+        case PtCr_neg:
+            if (pv->value.i == min_int)
+                pv->value.f = (float)pv->value.i, pv->type = CVT_FLOAT;
+            else
+                pv->value.i = -pv->value.i;
+            return true;
+        case PtCr_ceiling: case PtCr_cvi: case PtCr_floor:
+        case PtCr_round: case PtCr_truncate:
+            return true;
+        case PtCr_not:
+            pv->value.i = ~pv->value.i;
+            return true;
+        }
+        pv->value.f = (float)pv->value.i, pv->type = CVT_FLOAT;
+        break;
+    case CVT_FLOAT:
+        switch (op) {
+        case PtCr_cvi:
+            pv->value.i = (int)pv->value.f, pv->type = CVT_INT;
+            return true;
+        case PtCr_not:
+            return false;
+        }
+        break;
+    default:
+        return false;
+    }
+    if (op == PtCr_cvr)
+        return true;
+    if (calc_float_op(op, pv->value.f, 0, &f) < 0)
+        return false;
+    pv->value.f = f;
+    return true;
+}
+
+/* Compile a 2-operand arithmetic operator. */
+static bool
+calc_compile_op2(calc_compile_state_t *pcs, int op)
+{
+    calc_operand_t *args;
+    calc_value_t *pv1, *pv2;
+    float f1, f2, f;
+
+    if (pcs->depth < 2)
+        return false;
+    args = &pcs->stack[pcs->depth - 2];
+    pv1 = &args[0].value, pv2 = &args[1].value;
+    if ((args[0].reg < 0 && pv1->type != CVT_INT && pv1->type != CVT_FLOAT) ||
+        (args[1].reg < 0 && pv2->type != CVT_INT && pv2->type != CVT_FLOAT))
+        return false;
+    if (args[0].reg >= 0 || args[1].reg >= 0)
+        return calc_emit(pcs, op, 2);
+    if (pv1->type == CVT_INT && pv2->type == CVT_INT &&
+        (op == PtCr_add || op == PtCr_sub || op == PtCr_mul)) {
+        /* Use the same overflow tests as fn_PtCr_evaluate. */
+        int int1 = pv1->value.i, int2 = pv2->value.i;
+        int r;
+
+        switch (op) {
+        case PtCr_add:
+            r = (int)((uint)int1 + (uint)int2);
+            if ((int1 ^ int2) >= 0 && (r ^ int1) < 0)
+                pv1->value.f = (double)int1 + int2, pv1->type = CVT_FLOAT;
+            else
+                pv1->value.i = r;
+            break;
+        case PtCr_sub:
+            r = (int)((uint)int1 - (uint)int2);
+            if ((int1 ^ int2) < 0 && (r ^ int1) >= 0)
+                pv1->value.f = (double)int1 - int2, pv1->type = CVT_FLOAT;
+            else
+                pv1->value.i = r;
+            break;
+        default: {
+            double prod = (double)int1 * int2;
+
+            if (prod < min_int || prod > max_int)
+                pv1->value.f = prod, pv1->type = CVT_FLOAT;
+            else
+                pv1->value.i = (int)prod;
+        }
+        }
+    } else {
+        f1 = (pv1->type == CVT_INT ? (float)pv1->value.i : pv1->value.f);
+        f2 = (pv2->type == CVT_INT ? (float)pv2->value.i : pv2->value.f);
+        if (calc_float_op(op, f1, f2, &f) < 0)
+            return false;
+        pv1->value.f = f, pv1->type = CVT_FLOAT;
+    }
+    pcs->depth--;
+    return true;
+}
+
+/* Get the value of a constant integer operand, for stack operators. */
+static bool
+calc_const_int(const calc_compile_state_t *pcs, int index, int *pi)
+{
+    const calc_operand_t *pop;
+
+    if (pcs->depth <= index)
+        return false;
+    pop = &pcs->stack[pcs->depth - 1 - index];
+    if (pop->reg >= 0 || pop->value.type != CVT_INT)
+        return false;
+    *pi = pop->value.value.i;
+    return true;
+}
+
+/*
+ * Try to compile a PostScript Calculator function.  If the program
+ * doesn't qualify, or we run out of memory, it is simply interpreted.
+ */
+static void
+fn_PtCr_compile(gs_function_PtCr_t *pfn, gs_memory_t *mem)
+{
+    calc_compile_state_t *pcs;
+    const byte *p = pfn->params.ops.data;
+    int m = pfn->params.m, n = pfn->params.n;
+    int i, j, k;
+
+    pfn->compiled = NULL;
+    pfn->head.procs.evaluate = (fn_evaluate_proc_t) fn_PtCr_evaluate;
+    pcs = (calc_compile_state_t *)
+        gs_alloc_bytes(mem, sizeof(*pcs), "fn_PtCr_compile");
+    if (pcs == NULL)
+        return;
+    pcs->num_consts = pcs->num_insns = 0;
+    for (i = 0; i < m; ++i)
+        pcs->stack[i].reg = i;
+    pcs->depth = m;
+    for (; *p != PtCr_return; ++p) {
+        calc_operand_t *top = &pcs->stack[pcs->depth];
+
+        switch (*p) {
+        case PtCr_abs: case PtCr_ceiling: case PtCr_cos: case PtCr_cvi:
+        case PtCr_cvr: case PtCr_floor: case PtCr_ln: case PtCr_log:
+        case PtCr_neg: case PtCr_not: case PtCr_round: case PtCr_sin:
+        case PtCr_sqrt: case PtCr_truncate:
+            if (!calc_compile_op1(pcs, *p))
+                goto out;
+            continue;
+        case PtCr_add: case PtCr_atan: case PtCr_div: case PtCr_exp:
+        case PtCr_mul: case PtCr_sub:
+            if (!calc_compile_op2(pcs, *p))
+                goto out;
+            continue;
+        case PtCr_copy:
+            if (!calc_const_int(pcs, 0, &i) || i < 0 || i >= pcs->depth ||
+                pcs->depth - 1 + i > MAX_VSTACK)
+                goto out;
+            memcpy(top - 1, top - 1 - i, i * sizeof(*top));
+            pcs->depth += i - 1;
+            continue;
+        case PtCr_dup:
+            if (pcs->depth < 1 || pcs->depth == MAX_VSTACK)
+                goto out;
+            top[0] = top[-1];
+            pcs->depth++;
+            continue;
+        case PtCr_exch:
+            if (pcs->depth < 2)
+                goto out;
+            top[0] = top[-1], top[-1] = top[-2], top[-2] = top[0];
+            continue;
+        case PtCr_index:
+            if (!calc_const_int(pcs, 0, &i) || i < 0 || i >= pcs->depth - 1)
+                goto out;
+            top[-1] = top[-2 - i];
+            continue;
+        case PtCr_pop:
+            if (pcs->depth < 1)
+                goto out;
+            pcs->depth--;
+            continue;
+        case PtCr_roll: {
+            calc_operand_t temp[MAX_VSTACK];
+
+            if (!calc_const_int(pcs, 1, &i) || !calc_const_int(pcs, 0, &j) ||
+                i < 0 || i > pcs->depth - 2)
+                goto out;
+            pcs->depth -= 2;
+            top -= 2;
+            if (i == 0)
+                continue;
+            j %= i;
+            if (j < 0)
+                j += i;
+            memcpy(temp, top - i, i * sizeof(*top));
+            for (k = 0; k < i; ++k)
+                top[k - i] = temp[(k + i - j) % i];
+            continue;
+        }
+        case PtCr_byte:
+            top->value.value.i = *++p, top->value.type = CVT_INT;
+            goto push;
+        case PtCr_int:
+            memcpy(&top->value.value.i, p + 1, sizeof(int));
+            top->value.type = CVT_INT;
+            p += sizeof(int);
+            goto push;
+        case PtCr_float:
+            memcpy(&top->value.value.f, p + 1, sizeof(float));
+            top->value.type = CVT_FLOAT;
+            p += sizeof(float);
+            goto push;
+        default:		/* control flow, comparisons, integer operators */
+            goto out;
+        }
+    push:
+        if (pcs->depth == MAX_VSTACK)
+            goto out;
+        top->reg = -1;
+        pcs->depth++;
+    }
+    if (pcs->depth != n)
+        goto out;
+    for (i = 0; i < n; ++i) {
+        calc_operand_t *pop = &pcs->stack[i];
+
+        if (pop->reg < 0 && pop->value.type != CVT_INT &&
+            pop->value.type != CVT_FLOAT)
+            goto out;
+        if ((pop->reg = calc_operand_reg(pcs, pop)) < 0)
+            goto out;
+    }
+    if (m + pcs->num_consts + pcs->num_insns > MAX_CALC_REGS)
+        goto out;
+    {
+        uint size = sizeof(calc_program_t) +
+            pcs->num_consts * sizeof(float) +
+            pcs->num_insns * sizeof(calc_insn_t) + n * sizeof(ushort);
+        calc_program_t *pcp = (calc_program_t *)
+            gs_alloc_bytes(mem, size, "fn_PtCr_compile(program)");
+        int base_const = m, base_insn = m + pcs->num_consts;
+        float *consts;
+        calc_insn_t *insns;
+        ushort *outputs;
+
+#define CALC_REG(r)\
+  ((r) < MAX_CALC_REGS ? (r) :\
+   (r) < 2 * MAX_CALC_REGS ? base_const + (r) - MAX_CALC_REGS :\
+   base_insn + (r) - 2 * MAX_CALC_REGS)
+
+        if (pcp == NULL)
+            goto out;
+        pcp->num_consts = pcs->num_consts;
+        pcp->num_insns = pcs->num_insns;
+        pcp->num_regs = m + pcs->num_consts + pcs->num_insns;
+        consts = (float *)calc_program_consts(pcp);
+        insns = (calc_insn_t *)calc_program_insns(pcp);
+        outputs = (ushort *)calc_program_outputs(pcp);
+        memcpy(consts, pcs->consts, pcs->num_consts * sizeof(float));
+        for (i = 0; i < pcs->num_insns; ++i) {
+            insns[i].op = pcs->insns[i].op;
+            insns[i].dst = CALC_REG(pcs->insn_regs[i][0]);
+            insns[i].a = CALC_REG(pcs->insn_regs[i][1]);
+            insns[i].b = CALC_REG(pcs->insn_regs[i][2]);
+        }
+        for (i = 0; i < n; ++i)
+            outputs[i] = CALC_REG(pcs->stack[i].reg);
+#undef CALC_REG
+        pfn->compiled = (byte *)pcp;
+        pfn->head.procs.evaluate =
+            (fn_evaluate_proc_t) fn_PtCr_evaluate_compiled;
+    }
+ out:
+    gs_free_object(mem, pcs, "fn_PtCr_compile");
+}
+
 /* Test whether a PostScript Calculator function is monotonic. */
 static int
 fn_PtCr_is_monotonic(const gs_function_t * pfn_common,
@@ -746,6 +1218,7 @@ fn_PtCr_make_scaled(const gs_function_PtCr_t *pfn, gs_function_PtCr_t **ppsfn,
         gs_free_object(mem, psfn, "fn_PtCr_make_scaled");
         return_error(gs_error_VMerror);
     }
+    psfn->compiled = NULL;
     psfn->params = pfn->params;
     psfn->params.ops.data = ops;
     psfn->params.ops.size = opsize;
@@ -784,6 +1257,7 @@ fn_PtCr_make_scaled(const gs_function_PtCr_t *pfn, gs_function_PtCr_t **ppsfn,
     psfn->params.ops.data =
         gs_resize_string(mem, ops, opsize, psfn->params.ops.size,
                          "fn_PtCr_make_scaled");
+    fn_PtCr_compile(psfn, mem);
     *ppsfn = psfn;
     return 0;
 }
@@ -798,6 +1272,17 @@ gs_function_PtCr_free_params(gs_function_PtCr_params_t * params, gs_memory_t * m
     fn_common_free_params((gs_function_params_t *) params, mem);
 }
 
+/* Free a PostScript Calculator function. */
+static void
+fn_PtCr_free(gs_function_t * pfn_common, bool free_params, gs_memory_t * mem)
+{
+    gs_function_PtCr_t *pfn = (gs_function_PtCr_t *)pfn_common;
+
+    gs_free_object(mem, pfn->compiled, "fn_PtCr_free");
+    pfn->compiled = NULL;
+    fn_common_free(pfn_common, free_params, mem);
+}
+
 /* Serialize. */
 static int
 gs_function_PtCr_serialize(const gs_function_t * pfn, stream *s)
@@ -828,7 +1313,7 @@ gs_function_PtCr_init(gs_function_t ** ppfn,
             fn_common_get_params,
             (fn_make_scaled_proc_t) fn_PtCr_make_scaled,
             (fn_free_params_proc_t) gs_function_PtCr_free_params,
-            fn_common_free,
+            fn_PtCr_free,
             (fn_serialize_proc_t) gs_function_PtCr_serialize,
         }
     };
@@ -886,6 +1371,7 @@ gs_function_PtCr_init(gs_function_t ** ppfn,
         data_source_init_string2(&pfn->data_source, NULL, 0);
         pfn->data_source.access = calc_access;
         pfn->head = function_PtCr_head;
+        fn_PtCr_compile(pfn, mem);
         *ppfn = (gs_function_t *) pfn;
     }
     return 0;
@@ -306,6 +306,38 @@ romfs_open_file(gx_io_device *iodev, const char *fname, uint namelen,
     return 0;
 }
 
+/*
+ * Return the address and length of the data of a file opened on %rom%,
+ * for callers that can read it in place rather than through the stream.
+ * This is only possible when the file was stored uncompressed: mkromfs
+ * then lays the blocks out contiguously (every block but the last is a
+ * full ROMFS_BLOCKSIZE, a multiple of 4, so there is no padding between
+ * them). The data lives in the executable image, so it is read only and
+ * shared by every instance and process using it.
+ * Returns 1 and sets *pdata, *plen on success, 0 if the stream is not an
+ * uncompressed %rom% file.
+ */
+int
+romfs_file_data(stream *s, const byte **pdata, gs_offset_t *plen)
+{
+    const uint32_t *node;
+    uint32_t filelen;
+
+    if (s == NULL || s->procs.process != s_block_read_process ||
+        s->file == NULL || s->file_offset != 0 ||
+        s->file_limit != S_FILE_LIMIT_MAX)
+        return 0;
+    node = (const uint32_t *)s->file;
+    if (get_u32_big_endian(node) & 0x80000000)
+        return 0;		/* compressed */
+    filelen = get_u32_big_endian(node) & 0x7fffffff;
+    if (filelen == 0)
+        return 0;
+    *pdata = ((const byte *)node) + get_u32_big_endian(node + 2);
+    *plen = filelen;
+    return 1;
+}
+
 static int
 romfs_file_status(gx_io_device * iodev, const char *fname, struct stat *pstat)
 {
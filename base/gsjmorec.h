@@ -29,12 +29,15 @@
 #undef INPUT_SMOOTHING_SUPPORTED
 #undef DCT_FLOAT_SUPPORTED
 
+/* IDCT_SCALING_SUPPORTED is needed to decode DCTDecode images at */
+/* reduced size (see zfdctd.c), so leave it defined.  sdctd.c turns */
+/* off the chroma upsampling it would otherwise do at full size. */
+
 /* Progressive JPEG is required for PDF 1.3.
  * Don't undefine D_MULTISCAN_FILES_SUPPORTED and D_PROGRESSIVE_SUPPORTED
  */
 
 #undef BLOCK_SMOOTHING_SUPPORTED
-#undef IDCT_SCALING_SUPPORTED
 #undef UPSAMPLE_SCALING_SUPPORTED
 #undef UPSAMPLE_MERGING_SUPPORTED
 #undef QUANT_1PASS_SUPPORTED
@@ -37,9 +37,13 @@
 #include "gsimage.h"
 #include "gxhttile.h"
 #include "gsptype1.h"       /* for gx_dc_is_pattern1_color_with_trans */
+#include "gsptype2.h"       /* for gx_dc_is_pattern2_color */
 
 /* Forward references */
-static byte *compress_alpha_bits(const cached_char *, gs_memory_t *);
+static byte *compress_alpha_bits(const byte *, uint, uint, int, uint,
+                                 gs_memory_t *);
+static int image_char_mask(gs_show_enum *, const byte *, uint, int,
+                           int, int, int, int);
 
 /* Define a scale factor of 1. */
 static const gs_log2_scale_point scale_log2_1 =
@@ -328,7 +332,8 @@ gx_image_cached_char(register gs_show_enum * penum, register cached_char * cc)
             if (code >= 0)
                 return_check_interrupt(penum->memory, 0);
             /* copy_alpha failed, construct a monobit mask. */
-            bits = compress_alpha_bits(cc, penum->memory->non_gc_memory);
+            bits = compress_alpha_bits(bits, w, h, depth, cc_raster(cc),
+                                       penum->memory->non_gc_memory);
             if (bits == 0)
                 return 1;	/* VMerror, but recoverable */
         }
@@ -337,53 +342,134 @@ gx_image_cached_char(register gs_show_enum * penum, register cached_char * cc)
              x, y, w, h, gx_no_color_index, color);
         goto done;
     }
-    if (depth > 1) {		/* Complex color or fill_mask / copy_alpha failed, */
-        /* construct a monobit mask. */
-        bits = compress_alpha_bits(cc, penum->memory->non_gc_memory);
-        if (bits == 0)
-            return 1;		/* VMerror, but recoverable */
+    /* Complex color or fill_mask / copy_alpha failed. */
+    return image_char_mask(penum, bits, cc_raster(cc), depth, x, y, w, h);
+  done:if (bits != cc_bits(cc))
+        gs_free_object(penum->memory->non_gc_memory, bits, "compress_alpha_bits");
+    if (code > 0)
+        code = 0;
+    return_check_interrupt(penum->memory, code);
+}
 
-    } {				/* Use imagemask to render the character. */
-        gs_memory_t *mem = penum->memory->non_gc_memory;
-        gs_image_enum *pie =
-            gs_image_enum_alloc(mem, "image_char(image_enum)");
-        gs_image_t image;
-        int iy;
-        uint used, raster = (bits == cc_bits(cc) ? cc_raster(cc)
-                             : bitmap_raster(cc->width) );
-        int code1;
-
-        if (pie == 0) {
-            if (bits != cc_bits(cc))
-                gs_free_object(mem, bits,
-                               "compress_alpha_bits");
-            return 1;		/* VMerror, but recoverable */
-        }
-        /* Make a matrix that will place the image */
-        /* at (x,y) with no transformation. */
-        gs_image_t_init_mask(&image, true);
-        gs_make_translation((double) - x, (double) - y, &image.ImageMatrix);
-        gs_matrix_multiply(&ctm_only(pgs), &image.ImageMatrix, &image.ImageMatrix);
-        image.Width = w;
-        image.Height = h;
-        image.adjust = false;
-        code = gs_image_init(pie, &image, false, true, pgs);
-        switch (code) {
-            case 1:		/* empty image */
-                code = 0;
-            default:
-                break;
-            case 0:
-                for (iy = 0; iy < h && code >= 0; iy++)
-                    code = gs_image_next(pie, bits + iy * raster,
-                                         (w + 7) >> 3, &used);
+/*
+ * Queue a cached character on a glyph run if the device takes runs
+ * through gxdso_fill_mask_run, otherwise draw whatever is queued and
+ * then the character itself with gx_image_cached_char.  The queued case
+ * is the one where gx_image_cached_char would call fill_mask on the
+ * device, which therefore sees the same calls, just grouped.
+ * Return values are as for gx_image_cached_char.
+ */
+int
+gx_image_cached_char_run(gs_show_enum * penum, cached_char * cc,
+                         gx_glyph_run * run)
+{
+    gs_gstate *pgs = penum->pgs;
+    gx_device_color *pdevc = gs_currentdevicecolor_inline(pgs);
+    gx_device *dev = penum->imaging_dev ? penum->imaging_dev : penum->dev;
+    gxdso_mask_glyph *pg;
+    gs_fixed_point pt;
+    int x, y, depth;
+    int code;
+
+    if (run->dev != dev) {
+        gxdso_fill_mask_run_t req;
+
+        code = gx_flush_glyph_run(penum, run);
+        if (code < 0)
+            return code;
+        memset(&req, 0, sizeof(req));
+        req.dev = dev;
+        run->dev = dev;
+        run->accepted = dev_proc(dev, dev_spec_op)
+            (dev, gxdso_fill_mask_run, &req, sizeof(req)) > 0;
+    }
+    if (!run->accepted ||
+        (cc->xglyph != gx_no_xglyph && cc_pair(cc)->xfont != 0))
+        goto single;
+    code = gx_path_current_point_inline(pgs, &pt);
+    if (code < 0)
+        goto single;
+    code = gx_set_dev_color(pgs);
+    if (code != 0)
+        goto single;
+    /* Colors that gx_image_fill_masked renders through a clip path */
+    /* accumulator can't go in a run. */
+    if (pgs->log_op == lop_default &&
+        (gx_dc_is_pattern2_color(pdevc) ||
+         gx_dc_is_pattern1_color_clist_based(pdevc)))
+        goto single;
+    pt.x -= cc->offset.x + cc->subpix_origin.x;
+    x = fixed2int_var_rounded(pt.x) + penum->ftx;
+    pt.y -= cc->offset.y + cc->subpix_origin.y;
+    y = fixed2int_var_rounded(pt.y) + penum->fty;
+    if (x >= penum->obox.q.x || x + cc->width <= penum->obox.p.x ||
+        y >= penum->obox.q.y || y + cc->height <= penum->obox.p.y)
+        return 0;		/* entirely clipped out */
+    depth = (cc_depth(cc) == 3 ? 2 : cc_depth(cc));
+    if (run->count == GX_GLYPH_RUN_MAX ||
+        (run->count != 0 && depth != run->depth)) {
+        code = gx_flush_glyph_run(penum, run);
+        if (code < 0)
+            return code;
+    }
+    run->depth = depth;
+    pg = &run->glyphs[run->count++];
+    pg->data = cc_bits(cc);
+    pg->raster = cc_raster(cc);
+    pg->id = cc->id;
+    pg->x = x, pg->y = y;
+    pg->w = cc->width, pg->h = cc->height;
+    return 0;
+  single:
+    code = gx_flush_glyph_run(penum, run);
+    if (code < 0)
+        return code;
+    return gx_image_cached_char(penum, cc);
+}
+
+/*
+ * Draw the characters queued on a glyph run.  If the device fails part
+ * way, draw the remaining characters with imagemask, as
+ * gx_image_cached_char does when fill_mask fails.
+ */
+int
+gx_flush_glyph_run(gs_show_enum * penum, gx_glyph_run * run)
+{
+    gs_gstate *pgs = penum->pgs;
+    gxdso_fill_mask_run_t req;
+    gx_clip_path *pcpath;
+    int code;
+
+    if (run->count == 0)
+        return 0;
+    code = gx_effective_clip_path(pgs, &pcpath);
+    if (code >= 0) {
+        const gxdso_mask_glyph *pg;
+
+        req.dev = run->dev;
+        req.pdcolor = gs_currentdevicecolor_inline(pgs);
+        req.depth = run->depth;
+        req.lop = pgs->log_op;
+        req.pcpath = pcpath;
+        req.count = run->count;
+        req.glyphs = run->glyphs;
+        req.done = 0;
+        code = dev_proc(run->dev, dev_spec_op)
+            (run->dev, gxdso_fill_mask_run, &req, sizeof(req));
+        if (code < 0 && req.done >= 0 && req.done < run->count) {
+            for (pg = run->glyphs + req.done;
+                 pg < run->glyphs + run->count; pg++) {
+                code = image_char_mask(penum, pg->data, pg->raster,
+                                       run->depth, pg->x, pg->y,
+                                       pg->w, pg->h);
+                if (code != 0)
+                    break;
+            }
+            if (code > 0)
+                code = gs_note_error(gs_error_VMerror);
         }
-        code1 = gs_image_cleanup_and_free_enum(pie, pgs);
-        if (code >= 0 && code1 < 0)
-            code = code1;
     }
-  done:if (bits != cc_bits(cc))
-        gs_free_object(penum->memory->non_gc_memory, bits, "compress_alpha_bits");
+    run->count = 0;
     if (code > 0)
         code = 0;
     return_check_interrupt(penum->memory, code);
@@ -391,22 +477,75 @@ gx_image_cached_char(register gs_show_enum * penum, register cached_char * cc)
 
 /* ------ Image manipulation ------ */
 
+/*
+ * Render a character mask at (x,y) with imagemask, first reducing a mask
+ * with more than 1 bit of alpha to its high-order bit.  This is the last
+ * resort when the device can't draw the mask directly.
+ * Return 1 on VMerror, like gx_image_cached_char.
+ */
+static int
+image_char_mask(gs_show_enum * penum, const byte * data, uint raster,
+                int depth, int x, int y, int w, int h)
+{
+    gs_gstate *pgs = penum->pgs;
+    gs_memory_t *mem = penum->memory->non_gc_memory;
+    byte *bits = (byte *)data;	/* actually const */
+    gs_image_enum *pie;
+    gs_image_t image;
+    int iy;
+    uint used;
+    int code, code1;
+
+    if (depth > 1) {
+        /* Construct a monobit mask. */
+        bits = compress_alpha_bits(data, w, h, depth, raster, mem);
+        if (bits == 0)
+            return 1;		/* VMerror, but recoverable */
+        raster = bitmap_raster(w);
+    }
+    pie = gs_image_enum_alloc(mem, "image_char(image_enum)");
+    if (pie == 0) {
+        if (bits != data)
+            gs_free_object(mem, bits, "compress_alpha_bits");
+        return 1;		/* VMerror, but recoverable */
+    }
+    /* Make a matrix that will place the image */
+    /* at (x,y) with no transformation. */
+    gs_image_t_init_mask(&image, true);
+    gs_make_translation((double) - x, (double) - y, &image.ImageMatrix);
+    gs_matrix_multiply(&ctm_only(pgs), &image.ImageMatrix, &image.ImageMatrix);
+    image.Width = w;
+    image.Height = h;
+    image.adjust = false;
+    code = gs_image_init(pie, &image, false, true, pgs);
+    switch (code) {
+        case 1:		/* empty image */
+            code = 0;
+        default:
+            break;
+        case 0:
+            for (iy = 0; iy < h && code >= 0; iy++)
+                code = gs_image_next(pie, bits + iy * raster,
+                                     (w + 7) >> 3, &used);
+    }
+    code1 = gs_image_cleanup_and_free_enum(pie, pgs);
+    if (code >= 0 && code1 < 0)
+        code = code1;
+    if (bits != data)
+        gs_free_object(mem, bits, "compress_alpha_bits");
+    if (code > 0)
+        code = 0;
+    return_check_interrupt(penum->memory, code);
+}
+
 /*
  * Compress a mask with 2 or 4 bits of alpha to a monobit mask.
  * Allocate and return the address of the monobit mask.
  */
 static byte *
-compress_alpha_bits(const cached_char * cc, gs_memory_t * mem)
+compress_alpha_bits(const byte * data, uint width, uint height, int depth,
+                    uint sraster, gs_memory_t * mem)
 {
-    const byte *data = cc_const_bits(cc);
-    uint width = cc->width;
-    uint height = cc->height;
-    /* With 4x2 scale, depth == 3.
-     * An example is -dTextAlphaBits=4 comparefiles/fonttest.pdf .
-     * We need to map 4 bitmap bits to 2 alpha bits.
-     */
-    int depth = (cc_depth(cc) == 3 ? 2 : cc_depth(cc));
-    uint sraster = cc_raster(cc);
     uint sskip = sraster - ((width * depth + 7) >> 3);
     uint draster = bitmap_raster(width);
     uint dskip = draster - ((width + 7) >> 3);
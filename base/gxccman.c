@@ -865,7 +865,16 @@ gs_purge_font_from_char_caches_forced(gs_font * font, bool force)
     for (; count--; pair++) {
         if (pair->font == font) {
             if (!force && uid_is_valid(&pair->UID)) {	/* Keep the entry. */
-                gs_clean_fm_pair(dir, pair);
+                /*
+                 * Also keep the TrueType interpreter instance: it holds
+                 * copies of the font programs and the state left by
+                 * running 'fpgm' and 'prep' for this matrix, none of which
+                 * point to the font data, so a font with the same UID can
+                 * use it without running them again.  font_restore
+                 * (zfont.c) does the same for pairs that survive a restore.
+                 */
+                if_debug1m('k', dir->memory, "[k]cleaning pair 0x%lx\n", (ulong) pair);
+                pair->font = NULL;
             } else {
                 int code = gs_purge_fm_pair(dir, pair, 0);
 
@@ -24,15 +24,21 @@
 #include "gxfrac.h"
 #include "gscspace.h"
 
-/* Cache for DeviceN color.  Note that currently this is a 1-entry cache. */
+/*
+ * Cache for DeviceN and Separation color.  This is a small direct-mapped
+ * table indexed by a hash of the tint values; each entry holds the tints
+ * followed by the tint transform results in the alternate space.  Color
+ * spaces with too many components for an entry are not cached.
+ */
+#define DEVICE_N_MAP_CACHE_SIZE 16		/* power of 2, <= 32 */
+#define DEVICE_N_MAP_CACHE_MAX_VALUES 16	/* inputs + outputs */
 struct gs_device_n_map_s {
     rc_header rc;
     int (*tint_transform)(const float *in, float *out,
                           const gs_gstate *pgs, void *data);
     void *tint_transform_data;
-    bool cache_valid;
-    float tint[GS_CLIENT_COLOR_MAX_COMPONENTS];
-    frac conc[GX_DEVICE_COLOR_MAX_COMPONENTS];
+    uint cache_valid;		/* mask of valid entries */
+    float cache[DEVICE_N_MAP_CACHE_SIZE][DEVICE_N_MAP_CACHE_MAX_VALUES];
 };
 #define private_st_device_n_map() /* in gscdevn.c */\
   gs_private_st_ptrs1(st_device_n_map, gs_device_n_map, "gs_device_n_map",\
@@ -42,6 +48,11 @@ struct gs_device_n_map_s {
 int alloc_device_n_map(gs_device_n_map ** ppmap, gs_memory_t * mem,
                        client_name_t cname);
 
+/* Run a tint transform, using the map's cache. */
+int gx_device_n_map_tint_transform(gs_device_n_map *pmap, const float *in,
+                                   int num_in, float *out, int num_out,
+                                   const gs_gstate *pgs);
+
 struct gs_device_n_colorant_s {
     rc_header rc;
     char *colorant_name;
@@ -952,6 +952,16 @@ show_move(gs_show_enum * penum)
     }
     return 0;
 }
+/* Draw any queued cached characters before returning 'code' from */
+/* show_proceed. */
+static int
+show_flush_glyph_run(gs_show_enum * penum, gx_glyph_run * run, int code)
+{
+    int code1 = gx_flush_glyph_run(penum, run);
+
+    return (code1 < 0 && code >= 0 ? code1 : code);
+}
+
 /* Process next character */
 static int
 show_proceed(gs_show_enum * penum)
@@ -971,6 +981,7 @@ show_proceed(gs_show_enum * penum)
     int code, start;
     cached_char *cc;
     gs_log2_scale_point log2_scale;
+    gx_glyph_run run;
 
     if (penum->charpath_flag == cpm_show && SHOW_USES_OUTLINE(penum)) {
         code = gs_gstate_color_load(pgs);
@@ -984,17 +995,26 @@ show_proceed(gs_show_enum * penum)
     /* can_cache >= 0 allows us to use cached characters, */
     /* even if we can't make new cache entries. */
     if (penum->can_cache >= 0) {
-        /* Loop with cache */
+        /* Loop with cache.  Cached characters are queued on 'run', */
+        /* which must be flushed whenever we leave the loop. */
+        run.dev = 0;
+        run.count = 0;
         for (;;) {
             start = penum->index;
             switch ((code = get_next_char_glyph((gs_text_enum_t *)penum,
                                                 &chr, &glyph))
                     ) {
                 default:        /* error */
-                    return code;
+                    return show_flush_glyph_run(penum, &run, code);
                 case 2: /* done */
+                    code = gx_flush_glyph_run(penum, &run);
+                    if (code < 0)
+                        return code;
                     return show_finish(penum);
                 case 1: /* font change */
+                    code = gx_flush_glyph_run(penum, &run);
+                    if (code < 0)
+                        return code;
                     pfont = penum->fstack.items[penum->fstack.depth].font;
                     penum->current_font = pfont;
                     pgs->char_tm_valid = false;
@@ -1034,23 +1054,23 @@ show_proceed(gs_show_enum * penum)
                         code = compute_glyph_raster_params(penum, false,
                                     &alpha_bits, &depth, &subpix_origin, &log2_scale);
                         if (code < 0)
-                            return code;
+                            return show_flush_glyph_run(penum, &run, code);
                         if (pair == 0) {
                             code = gx_lookup_fm_pair(pfont, &char_tm_only(pgs), &log2_scale,
                                 penum->charpath_flag != cpm_show, &pair);
                             if (code < 0)
-                                return code;
+                                return show_flush_glyph_run(penum, &run, code);
                         }
                         penum->pair = pair;
                         if (glyph == GS_NO_GLYPH || SHOW_IS_ALL_OF(penum, TEXT_NO_CACHE)) {
                             cc = 0;
-                            goto no_cache;
+                            goto no_cache_flush;
                         }
                         cc = gx_lookup_cached_char(pfont, pair, glyph, wmode,
                                                    depth, &subpix_origin);
                     }
                     if (cc == 0) {
-                        goto no_cache;
+                        goto no_cache_flush;
                     }
                     /* Character is in cache. */
                     /* We might be doing .charboxpath or stringwidth; */
@@ -1089,9 +1109,9 @@ show_proceed(gs_show_enum * penum)
                         if (code < 0)
                             return code;
                     } else if (SHOW_IS_DRAWING(penum)) {
-                        code = gx_image_cached_char(penum, cc);
+                        code = gx_image_cached_char_run(penum, cc, &run);
                         if (code < 0)
-                            return code;
+                            return show_flush_glyph_run(penum, &run, code);
                         else if (code > 0) {
                             cc = 0;
                             goto no_cache;
@@ -1109,10 +1129,14 @@ show_proceed(gs_show_enum * penum)
                         code = show_fast_move(pgs, &cc->wxy);
                     if (code) {
                         /* Might be kshow, glyph is stored above. */
-                        return code;
+                        return show_flush_glyph_run(penum, &run, code);
                     }
             }
         }
+  no_cache_flush:
+        code = gx_flush_glyph_run(penum, &run);
+        if (code < 0)
+            return code;
     } else {
         start = penum->index;
         /* Can't use cache */
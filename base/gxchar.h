@@ -22,6 +22,7 @@
 
 #include "gschar.h"
 #include "gxtext.h"
+#include "gxdevsop.h"
 
 struct gs_show_enum_s {
     /* Put this first for subclassing. */
@@ -45,6 +46,24 @@ cached_char *
             gx_lookup_cached_char(const gs_font *, const cached_fm_pair *, gs_glyph, int, int, gs_fixed_point *);
 
 int gx_image_cached_char(gs_show_enum *, cached_char *);
+
+/*
+ * A run of cached characters queued by show_proceed, to be drawn with a
+ * single gxdso_fill_mask_run call when the device supports it.  The bits
+ * are referenced in place, so the run must be flushed before anything
+ * that might add to or purge the character cache.
+ */
+#define GX_GLYPH_RUN_MAX 64
+typedef struct gx_glyph_run_s {
+    gx_device *dev;		/* device the query was made on, or 0 */
+    bool accepted;		/* dev accepts gxdso_fill_mask_run */
+    int depth;			/* depth of the queued masks */
+    int count;
+    gxdso_mask_glyph glyphs[GX_GLYPH_RUN_MAX];
+} gx_glyph_run;
+
+int gx_image_cached_char_run(gs_show_enum *, cached_char *, gx_glyph_run *);
+int gx_flush_glyph_run(gs_show_enum *, gx_glyph_run *);
 void gx_compute_text_oversampling(const gs_show_enum * penum, const gs_font *pfont,
                                   int alpha_bits, gs_log2_scale_point *p_log2_scale);
 int set_char_width(gs_show_enum *penum, gs_gstate *pgs, double wx, double wy);
@@ -328,6 +328,8 @@ dev_proc_process_page(clist_process_page);
 
 /* In gxclimag.c */
 dev_proc_fill_mask(clist_fill_mask);
+struct gxdso_fill_mask_run_s;
+int clist_fill_mask_run(gx_device *dev, struct gxdso_fill_mask_run_s *req);
 dev_proc_begin_typed_image(clist_begin_typed_image);
 dev_proc_create_compositor(clist_create_compositor);
 
@@ -133,12 +133,18 @@ palette_has_color(const gs_color_space *pcs, const gs_pixel_image_t * const pim)
 
 /* ------ Driver procedures ------ */
 
-int
-clist_fill_mask(gx_device * dev,
-                const byte * data, int data_x, int raster, gx_bitmap_id id,
-                int rx, int ry, int rwidth, int rheight,
-                const gx_drawing_color * pdcolor, int depth,
-                gs_logical_operation_t lop, const gx_clip_path * pcpath)
+/*
+ * Write one fill_mask to the command list.  The caller has already made
+ * the checks that depend only on the color, lop and clip path, which
+ * clist_fill_mask_run makes once for a whole run of masks.
+ */
+static int
+clist_put_fill_mask(gx_device * dev,
+                    const byte * data, int data_x, int raster, gx_bitmap_id id,
+                    int rx, int ry, int rwidth, int rheight,
+                    const gx_drawing_color * pdcolor, int depth,
+                    gs_logical_operation_t lop, const gx_clip_path * pcpath,
+                    bool slow_rop)
 {
     gx_device_clist_writer * const cdev =
         &((gx_device_clist *)dev)->writer;
@@ -151,41 +157,24 @@ clist_fill_mask(gx_device * dev,
     byte copy_op =
         (depth > 1 ? cmd_op_copy_color_alpha :
          cmd_op_copy_mono_planes);  /* Plane not needed here */
-    bool slow_rop =
-        cmd_slow_rop(dev, lop_know_S_0(lop), pdcolor) ||
-        cmd_slow_rop(dev, lop_know_S_1(lop), pdcolor);
     cmd_rects_enum_t re;
 
-    /* If depth > 1, this call will be translated to a copy_alpha call. */
-    /* if the target device can't perform copy_alpha, exit now. */
-    if (depth > 1 && (cdev->disable_mask & clist_disable_copy_alpha) != 0)
-        return_error(gs_error_unknownerror);
-
     crop_copy(cdev, data, data_x, raster, id, rx, ry, rwidth, rheight);
     if (rwidth <= 0 || rheight <= 0)
         return 0;
     y0 = ry;                    /* must do after fit_copy */
 
-    /* If non-trivial clipping & complex clipping disabled, default */
-    /* Also default for uncached bitmap or non-default lop; */
-    /* We could handle more RasterOp cases here directly, but it */
-    /* doesn't seem worth the trouble right now. */
-    /* Lastly, the command list will translate calls with depth > 1 to */
-    /* copy_alpha calls, so the device color must be pure */
+    /* If non-trivial clipping & complex clipping disabled, default. */
+    /* Also default for uncached bitmap. */
     if (((cdev->disable_mask & clist_disable_complex_clip) &&
          !check_rect_for_trivial_clip(pcpath, rx, ry, rx + rwidth, ry + rheight)) ||
-        gs_debug_c('`') || id == gx_no_bitmap_id || lop != lop_default ||
-        (depth > 1 && !color_writes_pure(pdcolor, lop))
+        id == gx_no_bitmap_id
         )
   copy:
         return gx_default_fill_mask(dev, data, data_x, raster, id,
                                     rx, ry, rwidth, rheight, pdcolor, depth,
                                     lop, pcpath);
 
-    if (cmd_check_clip_path(cdev, pcpath))
-        cmd_clear_known(cdev, clip_path_known);
-    if (cdev->permanent_error < 0)
-      return (cdev->permanent_error);
     /* If needed, update the trans_bbox */
     if (cdev->pdf14_needed) {
         gs_int_rect bbox;
@@ -286,6 +275,100 @@ clist_fill_mask(gx_device * dev,
     return 0;
 }
 
+int
+clist_fill_mask(gx_device * dev,
+                const byte * data, int data_x, int raster, gx_bitmap_id id,
+                int rx, int ry, int rwidth, int rheight,
+                const gx_drawing_color * pdcolor, int depth,
+                gs_logical_operation_t lop, const gx_clip_path * pcpath)
+{
+    gx_device_clist_writer * const cdev =
+        &((gx_device_clist *)dev)->writer;
+    bool slow_rop;
+
+    /* If depth > 1, this call will be translated to a copy_alpha call. */
+    /* if the target device can't perform copy_alpha, exit now. */
+    if (depth > 1 && (cdev->disable_mask & clist_disable_copy_alpha) != 0)
+        return_error(gs_error_unknownerror);
+
+    /* Default for non-default lop; */
+    /* We could handle more RasterOp cases here directly, but it */
+    /* doesn't seem worth the trouble right now. */
+    /* Lastly, the command list will translate calls with depth > 1 to */
+    /* copy_alpha calls, so the device color must be pure */
+    if (gs_debug_c('`') || lop != lop_default ||
+        (depth > 1 && !color_writes_pure(pdcolor, lop))
+        )
+        return gx_default_fill_mask(dev, data, data_x, raster, id,
+                                    rx, ry, rwidth, rheight, pdcolor, depth,
+                                    lop, pcpath);
+
+    slow_rop =
+        cmd_slow_rop(dev, lop_know_S_0(lop), pdcolor) ||
+        cmd_slow_rop(dev, lop_know_S_1(lop), pdcolor);
+    if (cmd_check_clip_path(cdev, pcpath))
+        cmd_clear_known(cdev, clip_path_known);
+    if (cdev->permanent_error < 0)
+      return (cdev->permanent_error);
+    return clist_put_fill_mask(dev, data, data_x, raster, id,
+                               rx, ry, rwidth, rheight, pdcolor, depth,
+                               lop, pcpath, slow_rop);
+}
+
+/*
+ * Handle gxdso_fill_mask_run: the same as clist_fill_mask for each
+ * glyph of the run, but the color, lop and clip path are only checked
+ * once.  A query (count == 0) returns 1 if we accept runs.
+ */
+int
+clist_fill_mask_run(gx_device * dev, gxdso_fill_mask_run_t * req)
+{
+    gx_device_clist_writer * const cdev =
+        &((gx_device_clist *)dev)->writer;
+    const gxdso_mask_glyph *pg = req->glyphs;
+    int depth = req->depth;
+    bool slow_rop;
+    int i, code;
+
+    /* Refuse runs meant for a device that overrides our fill_mask. */
+    if (req->dev != dev || dev_proc(dev, fill_mask) != clist_fill_mask)
+        return (req->count == 0 ? 0 : gs_error_undefined);
+    if (req->count == 0)
+        return 1;
+    req->done = 0;
+    if ((depth > 1 && (cdev->disable_mask & clist_disable_copy_alpha) != 0) ||
+        gs_debug_c('`') || req->lop != lop_default ||
+        (depth > 1 && !color_writes_pure(req->pdcolor, req->lop))
+        ) {
+        for (i = 0; i < req->count; i++, pg++) {
+            code = clist_fill_mask(dev, pg->data, 0, pg->raster, pg->id,
+                                   pg->x, pg->y, pg->w, pg->h,
+                                   req->pdcolor, depth, req->lop, req->pcpath);
+            if (code < 0)
+                return code;
+            req->done++;
+        }
+        return 0;
+    }
+    slow_rop =
+        cmd_slow_rop(dev, lop_know_S_0(req->lop), req->pdcolor) ||
+        cmd_slow_rop(dev, lop_know_S_1(req->lop), req->pdcolor);
+    if (cmd_check_clip_path(cdev, req->pcpath))
+        cmd_clear_known(cdev, clip_path_known);
+    if (cdev->permanent_error < 0)
+      return (cdev->permanent_error);
+    for (i = 0; i < req->count; i++, pg++) {
+        code = clist_put_fill_mask(dev, pg->data, 0, pg->raster, pg->id,
+                                   pg->x, pg->y, pg->w, pg->h,
+                                   req->pdcolor, depth, req->lop,
+                                   req->pcpath, slow_rop);
+        if (code < 0)
+            return code;
+        req->done++;
+    }
+    return 0;
+}
+
 /* ------ Bitmap image driver procedures ------ */
 
 /* Define the structure for keeping track of progress through an image. */
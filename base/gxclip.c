@@ -212,6 +212,35 @@ gx_make_clip_device_in_heap(gx_device_clip * dev, const gx_clip_path *pcpath, gx
     gx_device_retain((gx_device *)dev, true); /* will free explicitly */
     (*dev_proc(dev, open_device)) ((gx_device *)dev);
 }
+
+/*
+ * If dev is a clipping device that clips to a single rectangle (with no
+ * translation), intersect *prect with that rectangle and return the
+ * target device, so that clients drawing many rectangles can bypass the
+ * clipper.  Otherwise return NULL.
+ */
+gx_device *
+gx_clip_device_single_rect_target(gx_device *dev, gs_int_rect *prect)
+{
+    gx_device_clip *rdev = (gx_device_clip *)dev;
+    const gx_clip_rect *rp;
+
+    if (dev_proc(dev, get_clipping_box) != clip_get_clipping_box ||
+        rdev->list.count != 1 || rdev->list.transpose ||
+        rdev->translation.x != 0 || rdev->translation.y != 0)
+        return NULL;
+    rp = &rdev->list.single;
+    if (prect->p.x < rp->xmin)
+        prect->p.x = rp->xmin;
+    if (prect->q.x > rp->xmax)
+        prect->q.x = rp->xmax;
+    if (prect->p.y < rp->ymin)
+        prect->p.y = rp->ymin;
+    if (prect->q.y > rp->ymax)
+        prect->q.y = rp->ymax;
+    return rdev->target;
+}
+
 /* Define debugging statistics for the clipping loops. */
 #if defined(DEBUG) && !defined(GS_THREADSAFE)
 struct stats_clip_s {
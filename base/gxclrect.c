@@ -626,6 +626,8 @@ clist_dev_spec_op(gx_device *pdev, int dev_spec_op, void *data, int size)
             return 0;
         }
     }
+    if (dev_spec_op == gxdso_fill_mask_run)
+        return clist_fill_mask_run(pdev, (gxdso_fill_mask_run_t *)data);
     if (dev_spec_op == gxdso_restrict_bbox) {
         gx_device_clist_writer *cwdev = &((gx_device_clist *)pdev)->writer;
         gs_int_rect *ibox = (gs_int_rect *)data;
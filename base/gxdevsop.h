@@ -134,6 +134,25 @@ typedef struct pattern_accum_param_t {
     int pinst_id;
 }pattern_accum_param_s;
 
+/* structures used to pass a run of glyph masks to gxdso_fill_mask_run */
+typedef struct gxdso_mask_glyph_s {
+    const byte *data;
+    int raster;
+    gx_bitmap_id id;
+    int x, y, w, h;
+} gxdso_mask_glyph;
+
+typedef struct gxdso_fill_mask_run_s {
+    gx_device *dev;             /* the device fill_mask would be called on */
+    const gx_drawing_color *pdcolor;
+    int depth;
+    gs_logical_operation_t lop;
+    const gx_clip_path *pcpath;
+    int count;
+    const gxdso_mask_glyph *glyphs;
+    int done;                   /* set by the device: glyphs drawn */
+} gxdso_fill_mask_run_t;
+
 enum {
     /* All gxdso_ keys must be defined in this structure.
      * Do NOT rely on your particular gxdso_ having a particular value.
@@ -342,6 +361,20 @@ enum {
      * 0 otherwise.
      */
     gxdso_is_encoding_direct,
+    /* gxdso_fill_mask_run:
+     *     data = gxdso_fill_mask_run_t *
+     *     size = sizeof(gxdso_fill_mask_run_t)
+     * Equivalent to calling fill_mask for each of 'count' glyph bitmaps
+     * in turn, all with the same color, depth, lop and clip path; used by
+     * the text code to hand over runs of cached characters in one call.
+     * With count == 0 it is a query, returning > 0 if the device accepts
+     * runs. A device must only accept the call if data->dev is the device
+     * itself: forwarding devices that pass it on unchanged must not have
+     * their own fill_mask bypassed.  On an error the device sets data->done
+     * to the number of glyphs it drew; the caller draws the rest another
+     * way, as it would after a fill_mask error.
+     */
+    gxdso_fill_mask_run,
 
     /* Debug only dsos follow here */
 #ifdef DEBUG
@@ -78,6 +78,13 @@ extern_st(st_cmap_lookup_range_element);
 /*
  * The main body of data in a CMap is two code maps, one for defined
  * characters, one for notdefs.
+ *
+ * Decoding scans the lookup ranges from last to first.  To avoid visiting
+ * ranges that cannot match, a code map may carry an index by the first
+ * byte of the code: index[b] .. index[b + 1] - 1 are positions in
+ * index[257 ..] holding, in scan order, the lookup ranges whose prefix or
+ * keys can start with byte b.  The index is optional (NULL means scan all
+ * the ranges) and is built by gs_cmap_adobe1_build_index.
  */
 typedef struct gx_code_space_s {
     gx_code_space_range_t *ranges;
@@ -86,6 +93,7 @@ typedef struct gx_code_space_s {
 typedef struct gx_code_map_s {
     gx_cmap_lookup_range_t *lookup;
     int num_lookup;
+    int *index;			/* [257 + total], see above */
 } gx_code_map_t;
 struct gs_cmap_adobe1_s {
     GS_CMAP_COMMON;
@@ -98,10 +106,11 @@ struct gs_cmap_adobe1_s {
 
 extern_st(st_cmap_adobe1);
 #define public_st_cmap_adobe1()	/* in gsfcmap1.c */\
-  gs_public_st_suffix_add4(st_cmap_adobe1, gs_cmap_adobe1_t,\
+  gs_public_st_suffix_add6(st_cmap_adobe1, gs_cmap_adobe1_t,\
     "gs_cmap_adobe1_t", cmap_adobe1_enum_ptrs, cmap_adobe1_reloc_ptrs,\
     st_cmap,\
-    code_space.ranges, def.lookup, notdef.lookup, mark_glyph_data)
+    code_space.ranges, def.lookup, notdef.lookup, mark_glyph_data,\
+    def.index, notdef.index)
 
 /* ---------------- Procedures ---------------- */
 
@@ -115,4 +124,10 @@ int gs_cmap_adobe1_alloc(gs_cmap_adobe1_t **ppcmap, int wmode,
                          uint keys_size, uint values_size,
                          const gs_cid_system_info_t *pcidsi, gs_memory_t *mem);
 
+/*
+ * Build the first-byte indexes of the def and notdef maps.  Call this
+ * after the lookup ranges have been filled in and before the CMap is used.
+ */
+int gs_cmap_adobe1_build_index(gs_cmap_adobe1_t *pcmap, gs_memory_t *mem);
+
 #endif /* gxfcmap1_INCLUDED */
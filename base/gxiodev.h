@@ -198,6 +198,9 @@ struct_proc_finalize(io_device_finalize);
     io_device_enum_ptrs, io_device_reloc_ptrs, io_device_finalize, state)
 
 
+/* In gsiorom.c: the in-place data of an uncompressed %rom% file stream. */
+int romfs_file_data(stream *s, const byte **pdata, gs_offset_t *plen);
+
 int
 gs_iodev_init(gs_memory_t * mem);
 
@@ -31,6 +31,8 @@
 #include "gxpath.h"
 #include "gxshade.h"
 #include "gxdevcli.h"
+#include "gxdevmem.h"
+#include "gxcpath.h"
 #include "gxshade4.h"
 #include "gsicc_cache.h"
 
@@ -211,6 +213,120 @@ A_fill_region(A_fill_state_t * pfs, patch_fill_state_t *pfs1)
     return patch_fill(pfs1, curve, NULL, NULL);
 }
 
+/*
+ * Fill an axial shading directly into a memory device, one device row or
+ * column at a time.  This applies when the shading's isolines are
+ * vertical or horizontal in device space, so that each column (or row)
+ * of pixels has a single color: we evaluate the Function at the pixel
+ * centre and merge runs of equal device colors into rectangles, instead
+ * of decomposing the shading into patches and trapezoids.  Return 1 if
+ * the shading doesn't qualify.
+ */
+static int
+A_fill_direct(const A_fill_state_t *pfs, patch_fill_state_t *pfs1,
+              const gs_fixed_rect *clip_rect, float d0, float dd)
+{
+    const gs_shading_A_t *const psh = pfs->psh;
+    gs_gstate *pgs = pfs1->pgs;
+    gx_device *dev = pfs1->dev;
+    double len2 = pfs->delta.x * pfs->delta.x + pfs->delta.y * pfs->delta.y;
+    double a, b, c, dt;
+    gs_matrix imat;
+    gx_device_color devc, run_devc;
+    patch_color_t *pc;
+    byte *color_stack_ptr;
+    bool by_x, have_run = false;
+    int i0, i1, j0, j1, i, run_start = 0;
+    gs_int_rect crect;
+    int code = 0;
+
+    if (pfs1->unlinear || dev->color_info.depth < 8 || len2 == 0)
+        return 1;
+    crect.p.x = fixed2int_pixround(clip_rect->p.x);
+    crect.p.y = fixed2int_pixround(clip_rect->p.y);
+    crect.q.x = fixed2int_pixround(clip_rect->q.x);
+    crect.q.y = fixed2int_pixround(clip_rect->q.y);
+    if (!gs_device_is_memory(dev)) {
+        /* Look through a rectangular clip. */
+        dev = gx_clip_device_single_rect_target(dev, &crect);
+        if (dev == NULL || !gs_device_is_memory(dev))
+            return 1;
+    }
+    if (gs_matrix_invert(&ctm_only(pgs), &imat) < 0)
+        return 1;
+    /* t = a * X + b * Y + c in device space. */
+    a = (imat.xx * pfs->delta.x + imat.xy * pfs->delta.y) / len2;
+    b = (imat.yx * pfs->delta.x + imat.yy * pfs->delta.y) / len2;
+    c = ((imat.tx - psh->params.Coords[0]) * pfs->delta.x +
+         (imat.ty - psh->params.Coords[1]) * pfs->delta.y) / len2;
+    if (b == 0 && a != 0) {
+        by_x = true;
+        dt = a;
+        i0 = crect.p.x, i1 = crect.q.x;
+        j0 = crect.p.y, j1 = crect.q.y;
+    } else if (a == 0 && b != 0) {
+        by_x = false;
+        dt = b;
+        i0 = crect.p.y, i1 = crect.q.y;
+        j0 = crect.p.x, j1 = crect.q.x;
+    } else
+        return 1;
+    if (i1 <= i0 || j1 <= j0)
+        return 0;
+    color_stack_ptr = reserve_colors(pfs1, &pc, 1);
+    if (color_stack_ptr == NULL)
+        return_error(gs_error_unregistered); /* Must not happen. */
+    for (i = i0; i <= i1; i++) {
+        bool paint = false;
+
+        if (i < i1) {
+            double t = dt * (i + 0.5) + c;
+
+            paint = true;
+            if (t < 0) {
+                if (psh->params.Extend[0])
+                    t = 0;
+                else
+                    paint = false;
+            } else if (t > 1) {
+                if (psh->params.Extend[1])
+                    t = 1;
+                else
+                    paint = false;
+            }
+            if (paint) {
+                pc->t[0] = (float)(t * dd + d0);
+                pc->t[1] = 0;
+                patch_resolve_color(pc, pfs1);
+                code = patch_color_to_device_color(pfs1, pc, &devc);
+                if (code < 0)
+                    break;
+                if (have_run && gx_device_color_equal(&devc, &run_devc))
+                    continue;
+            }
+        }
+        if (have_run) {
+            code = (by_x ?
+                    gx_fill_rectangle_device_rop(run_start, j0, i - run_start,
+                                                 j1 - j0, &run_devc, dev,
+                                                 pgs->log_op) :
+                    gx_fill_rectangle_device_rop(j0, run_start, j1 - j0,
+                                                 i - run_start, &run_devc, dev,
+                                                 pgs->log_op));
+            if (code < 0)
+                break;
+            have_run = false;
+        }
+        if (paint) {
+            run_devc = devc;
+            run_start = i;
+            have_run = true;
+        }
+    }
+    release_colors(pfs1, color_stack_ptr, 1);
+    return code;
+}
+
 static inline int
 gs_shading_A_fill_rectangle_aux(const gs_shading_t * psh0, const gs_rect * rect,
                             const gs_fixed_rect *clip_rect,
@@ -270,6 +386,9 @@ gs_shading_A_fill_rectangle_aux(const gs_shading_t * psh0, const gs_rect * rect,
     if (code < 0)
         goto fail;
     state.length = hypot(dist.x, dist.y);	/* device space line length */
+    code = A_fill_direct(&state, &pfs1, clip_rect, d0, dd);
+    if (code <= 0)
+        goto fail;
     code = A_fill_region(&state, &pfs1);
     if (psh->params.Extend[0] && t0 > t_rect.p.y) {
         if (code < 0)
@@ -3063,12 +3063,36 @@ static int
 mesh_triangle_rec(patch_fill_state_t *pfs,
         const shading_vertex_t *p0, const shading_vertex_t *p1, const shading_vertex_t *p2)
 {
+    bool inside_save = pfs->inside;
+
+    if (!pfs->inside) {
+        /* Skip triangles outside the clipping rectangle before
+           subdividing them. With a banding device each band renders
+           the whole mesh, so this is where most of the band time goes. */
+        gs_fixed_rect r, r1;
+
+        bbox_of_points(&r, &p0->p, &p1->p, &p2->p, NULL);
+        r.p.x -= INTERPATCH_PADDING;
+        r.p.y -= INTERPATCH_PADDING;
+        r.q.x += INTERPATCH_PADDING;
+        r.q.y += INTERPATCH_PADDING;
+        r1 = r;
+        rect_intersect(r, pfs->rect);
+        if (r.q.x <= r.p.x || r.q.y <= r.p.y)
+            return 0;
+        if (r1.p.x == r.p.x && r1.p.y == r.p.y &&
+            r1.q.x == r.q.x && r1.q.y == r.q.y)
+            pfs->inside = true;
+    }
     pfs->unlinear = !is_linear_color_applicable(pfs);
     if (manhattan_dist(&p0->p, &p1->p) < pfs->max_small_coord &&
         manhattan_dist(&p1->p, &p2->p) < pfs->max_small_coord &&
-        manhattan_dist(&p2->p, &p0->p) < pfs->max_small_coord)
-        return small_mesh_triangle(pfs, p0, p1, p2);
-    else {
+        manhattan_dist(&p2->p, &p0->p) < pfs->max_small_coord) {
+        int code = small_mesh_triangle(pfs, p0, p1, p2);
+
+        pfs->inside = inside_save;
+        return code;
+    } else {
         /* Subdivide into 4 triangles with 3 triangle non-lazy wedges.
            Doing so against the wedge_vertex_list_elem_buffer overflow.
            We could apply a smarter method, dividing long sides
@@ -3106,6 +3130,7 @@ mesh_triangle_rec(patch_fill_state_t *pfs,
         if (code >= 0)
             code = mesh_triangle_rec(pfs, &p01, &p12, &p20);
         release_colors_inline(pfs, color_stack_ptr, 3);
+        pfs->inside = inside_save;
         return code;
     }
 }
@@ -4188,6 +4213,20 @@ patch_fill(patch_fill_state_t *pfs, const patch_curve_t curve[4],
         if (code < 0)
             goto out;
     }
+    if (!pfs->inside) {
+        /* Skip patches outside the clipping rectangle (typically
+           another band) before computing the subdivision. */
+        gs_fixed_rect r;
+
+        tensor_patch_bbox(&r, &p);
+        r.p.x -= INTERPATCH_PADDING;
+        r.p.y -= INTERPATCH_PADDING;
+        r.q.x += INTERPATCH_PADDING;
+        r.q.y += INTERPATCH_PADDING;
+        rect_intersect(r, pfs->rect);
+        if (r.q.x <= r.p.x || r.q.y <= r.p.y)
+            goto out;
+    }
     /* How many subdividions of the patch in the u and v direction? */
     kv[0] = curve_samples(pfs, &p.pole[0][0], 4, pfs->fixed_flat);
     kv[1] = curve_samples(pfs, &p.pole[0][1], 4, pfs->fixed_flat);
@@ -1395,6 +1395,381 @@ set_thin_widths(register pl_ptr plp)
 #undef TRSIGN
 }
 
+/*
+ * Check whether a non-thin segment, together with its caps and the join
+ * to the next segment (if any), covers exactly a device-space rectangle.
+ * This is true for horizontal and vertical lines with butt or square caps
+ * whose join is either a straight continuation or a right-angle miter
+ * onto another axis-aligned segment: the miter corner is then covered by
+ * extending this segment by the half width of the next one.  This is the
+ * common case for HPGL/2 plots and engineering drawings, and lets us
+ * skip path construction entirely.  If it applies, store the rectangle
+ * in *prect and return true.
+ */
+static bool
+stroke_axis_aligned_rect(const gx_line_params * pgs_lp, pl_ptr plp,
+                         pl_ptr nplp, gs_line_cap start_cap,
+                         gs_line_cap end_cap, gs_line_join join,
+                         gs_fixed_rect * prect)
+{
+    gs_fixed_point o, e;
+    bool horiz;
+
+    if (plp->vector.y == 0 && plp->width.x == 0 && plp->e.cdelta.y == 0)
+        horiz = true;
+    else if (plp->vector.x == 0 && plp->width.y == 0 && plp->e.cdelta.x == 0)
+        horiz = false;
+    else
+        return false;
+    o = plp->o.p;
+    e = plp->e.p;
+    if (start_cap == gs_cap_square)
+        o.x -= plp->e.cdelta.x, o.y -= plp->e.cdelta.y;
+    else if (start_cap != gs_cap_butt)
+        return false;
+    if (nplp == 0) {
+        if (end_cap == gs_cap_square)
+            e.x += plp->e.cdelta.x, e.y += plp->e.cdelta.y;
+        else if (end_cap != gs_cap_butt)
+            return false;
+    } else {
+        if (nplp->thin || nplp->o.p.x != plp->e.p.x ||
+            nplp->o.p.y != plp->e.p.y)
+            return false;
+        if (horiz ? nplp->vector.y == 0 : nplp->vector.x == 0) {
+            /* Straight continuation: any join is covered by the bodies. */
+            if (horiz ? (nplp->vector.x ^ plp->vector.x) < 0 ||
+                        any_abs(nplp->width.y) != any_abs(plp->width.y) :
+                        (nplp->vector.y ^ plp->vector.y) < 0 ||
+                        any_abs(nplp->width.x) != any_abs(plp->width.x))
+                return false;
+        } else if (join == gs_join_miter &&
+                   pgs_lp->miter_limit * pgs_lp->miter_limit >= 2.0001) {
+            /*
+             * Right-angle miter onto a perpendicular axis-aligned line.
+             * If either segment is shorter than the other's half width,
+             * the outline overlaps itself around the corner; leave that
+             * to the general code so that the result doesn't change.
+             */
+            if (horiz) {
+                if (nplp->vector.x != 0 || nplp->width.y != 0 ||
+                    any_abs(plp->e.p.x - plp->o.p.x) < any_abs(nplp->width.x) ||
+                    any_abs(nplp->e.p.y - nplp->o.p.y) < any_abs(plp->width.y))
+                    return false;
+                e.x += (plp->vector.x < 0 ? -any_abs(nplp->width.x) :
+                        any_abs(nplp->width.x));
+            } else {
+                if (nplp->vector.y != 0 || nplp->width.x != 0 ||
+                    any_abs(plp->e.p.y - plp->o.p.y) < any_abs(nplp->width.y) ||
+                    any_abs(nplp->e.p.x - nplp->o.p.x) < any_abs(plp->width.x))
+                    return false;
+                e.y += (plp->vector.y < 0 ? -any_abs(nplp->width.y) :
+                        any_abs(nplp->width.y));
+            }
+        } else
+            return false;
+    }
+    prect->p.x = min(o.x, e.x) - any_abs(plp->width.x);
+    prect->q.x = max(o.x, e.x) + any_abs(plp->width.x);
+    prect->p.y = min(o.y, e.y) - any_abs(plp->width.y);
+    prect->q.y = max(o.y, e.y) + any_abs(plp->width.y);
+    return true;
+}
+
+/*
+ * Paint the pieces of a non-thin segment straight to the device.  The
+ * outline that stroke_add would build for a segment is the union of a
+ * body parallelogram, the convex join piece (a bevel triangle, a miter
+ * quadrilateral or a pie for a round join) and any round caps, and when
+ * the logical operation is idempotent that outline is filled on its own.
+ * So instead of building it, we fill each piece as trapezoids.  Growing
+ * a piece by the fill adjustment box before filling it with the centre-
+ * of-pixel rule paints exactly the pixels that any part of the piece
+ * touches, which is what the fill algorithm does with an adjustment of
+ * 1/2; with no adjustment the two rules are the same.
+ */
+#define STROKE_ARC_MAX_STEPS 64
+#define STROKE_PIECE_MAX_POINTS (STROKE_ARC_MAX_STEPS + 2)
+
+/*
+ * Round joins and caps are filled as polygons inscribed in their arcs,
+ * to within this many pixels.  This is about as close as the fill
+ * algorithm gets to the curves that stroke_add would use.
+ */
+#define STROKE_ARC_FLATNESS 0.05
+
+/* Points of a piece can't be further than this from the origin, */
+/* so that the trapezoid fill can't overflow. */
+#define STROKE_PIECE_MAX_COORD (max_fixed >> 2)
+
+/*
+ * Fill a convex polygon given by its vertices in cyclic order, after
+ * growing it by the fill adjustment.  Polygons with no area (which
+ * can only be parts of the outline of another piece) paint nothing.
+ */
+static int
+stroke_fill_convex(gx_device * dev, const gs_fixed_point * pts, int npts,
+                   fixed adjust, const gx_device_color * pdevc,
+                   gs_logical_operation_t lop)
+{
+    gs_fixed_point q[2 * STROKE_PIECE_MAX_POINTS + 4];
+    gs_fixed_point box[4];
+    fixed adjust_lo = (adjust == fixed_half ? fixed_half - fixed_epsilon :
+                       adjust);
+    double area = 0;
+    int i, k, m = 0, step = 1, start = 0, nq0 = -1, pq = -1;
+    int imin, imax, il, ir, nl, nr;
+    fixed y, ytop;
+    gs_fixed_edge left, right;
+
+    for (i = 2; i < npts; i++)
+        area += (double)(pts[i - 1].x - pts[0].x) * (pts[i].y - pts[0].y) -
+                (double)(pts[i - 1].y - pts[0].y) * (pts[i].x - pts[0].x);
+    if (area == 0)
+        return 0;
+    /* Walk the vertices counter-clockwise (taking y as going up). */
+    if (area < 0)
+        step = npts - 1, start = npts - 1;
+    /* Corners of the adjustment box, in the same order. */
+    box[0].x = adjust, box[0].y = -adjust_lo;
+    box[1].x = adjust, box[1].y = adjust;
+    box[2].x = -adjust_lo, box[2].y = adjust;
+    box[3].x = -adjust_lo, box[3].y = -adjust_lo;
+    /*
+     * Each edge moves out to the box corner that is furthest along its
+     * outward normal, and the box corners between those of consecutive
+     * edges go round the vertex between them.
+     */
+    for (i = 0, k = start; i < npts; i++, k = (k + step) % npts) {
+        const gs_fixed_point *a = &pts[k];
+        const gs_fixed_point *b = &pts[(k + step) % npts];
+        fixed nx = b->y - a->y, ny = a->x - b->x;
+        int nq;
+
+        if (nx == 0 && ny == 0)
+            continue;
+        nq = (ny < 0 && nx >= 0 ? 0 : nx > 0 && ny >= 0 ? 1 :
+              ny > 0 && nx <= 0 ? 2 : 3);
+        if (pq < 0)
+            nq0 = nq;
+        else if (pq != nq)
+            for (pq = (pq + 1) & 3; pq != nq; pq = (pq + 1) & 3)
+                q[m].x = a->x + box[pq].x, q[m++].y = a->y + box[pq].y;
+        q[m].x = a->x + box[nq].x, q[m++].y = a->y + box[nq].y;
+        q[m].x = b->x + box[nq].x, q[m++].y = b->y + box[nq].y;
+        pq = nq;
+    }
+    if (pq != nq0)
+        for (pq = (pq + 1) & 3; pq != nq0; pq = (pq + 1) & 3)
+            q[m].x = q[0].x - box[nq0].x + box[pq].x,
+                q[m++].y = q[0].y - box[nq0].y + box[pq].y;
+
+    /*
+     * Fill the result as trapezoids between successive vertex heights.
+     * Going forwards from the lowest vertex follows the right side.
+     */
+    imin = imax = 0;
+    for (i = 1; i < m; i++) {
+        if (q[i].y < q[imin].y)
+            imin = i;
+        if (q[i].y > q[imax].y)
+            imax = i;
+    }
+    il = ir = imin;
+    y = q[imin].y;
+    while (y < q[imax].y) {
+        int code;
+
+        for (;;) {
+            nl = (il == 0 ? m - 1 : il - 1);
+            if (q[nl].y > y || il == imax)
+                break;
+            il = nl;
+        }
+        for (;;) {
+            nr = (ir == m - 1 ? 0 : ir + 1);
+            if (q[nr].y > y || ir == imax)
+                break;
+            ir = nr;
+        }
+        if (il == imax || ir == imax)
+            break;
+        left.start = q[il], left.end = q[nl];
+        right.start = q[ir], right.end = q[nr];
+        ytop = min(q[nl].y, q[nr].y);
+        code = (*dev_proc(dev, fill_trapezoid))
+            (dev, &left, &right, y, ytop, false, pdevc, lop);
+        if (code < 0)
+            return code;
+        y = ytop;
+    }
+    return 0;
+}
+
+/*
+ * Store the points of an arc of the ellipse centred on c through c + u
+ * and c + t, where u and t are conjugate radii, from c + u through the
+ * angle a towards c + t.  Return the number of points, or -1 if there
+ * would be too many.
+ */
+static int
+stroke_arc_points(gs_fixed_point * pts, const gs_fixed_point * c,
+                  const gs_fixed_point * u, const gs_fixed_point * t,
+                  double a)
+{
+    double r = fixed2float(max(hypot((double)u->x, (double)u->y),
+                               hypot((double)t->x, (double)t->y)));
+    int i, n = 1;
+
+    if (r > STROKE_ARC_FLATNESS) {
+        n = (int)ceil(a / (2 * acos(1 - STROKE_ARC_FLATNESS / r)));
+        if (n > STROKE_ARC_MAX_STEPS)
+            return -1;
+        if (n < 1)
+            n = 1;
+    }
+    for (i = 0; i <= n; i++) {
+        double ca = cos(a * i / n), sa = sin(a * i / n);
+
+        pts[i].x = c->x + (fixed)(ca * u->x + sa * t->x);
+        pts[i].y = c->y + (fixed)(ca * u->y + sa * t->y);
+    }
+    return n + 1;
+}
+
+/* Store the points of a semicircular cap on an end of a line. */
+static int
+stroke_pie_cap_points(gs_fixed_point * pts, const_ep_ptr endp)
+{
+    gs_fixed_point u;
+
+    u.x = endp->co.x - endp->p.x, u.y = endp->co.y - endp->p.y;
+    return stroke_arc_points(pts, &endp->p, &u, &endp->cdelta, M_PI);
+}
+
+/*
+ * Paint a segment as above if we can.  Return 1, having painted
+ * nothing, if the segment needs the general code.
+ */
+static int
+stroke_fill_pieces(pl_ptr plp, pl_ptr nplp, gs_line_cap start_cap,
+                   gs_line_cap end_cap, gs_line_join join, int uniform,
+                   bool reflected, fixed adjust, gx_device * dev,
+                   const gs_gstate * pgs, const gx_device_color * pdevc)
+{
+    const gx_line_params *pgs_lp = gs_currentlineparams_inline(pgs);
+    gs_fixed_point body[4];
+    gs_fixed_point join_pts[STROKE_PIECE_MAX_POINTS];
+    gs_fixed_point scap[STROKE_PIECE_MAX_POINTS];
+    gs_fixed_point ecap[STROKE_PIECE_MAX_POINTS];
+    int njoin = 0, nscap = 0, necap = 0;
+    int i, code;
+
+    if ((plp->o.p.x == plp->e.p.x && plp->o.p.y == plp->e.p.y) ||
+        (start_cap != gs_cap_butt && start_cap != gs_cap_square &&
+         start_cap != gs_cap_round) ||
+        (end_cap != gs_cap_butt && end_cap != gs_cap_square &&
+         end_cap != gs_cap_round))
+        return 1;
+    if (cap_points((start_cap == gs_cap_square ? gs_cap_square :
+                    gs_cap_butt), &plp->o, body) < 0 ||
+        cap_points((end_cap == gs_cap_square ? gs_cap_square :
+                    gs_cap_butt), &plp->e, body + 2) < 0)
+        return 1;
+    if (start_cap == gs_cap_round &&
+        (nscap = stroke_pie_cap_points(scap, &plp->o)) < 0)
+        return 1;
+    if (nplp == 0) {
+        if (end_cap == gs_cap_round &&
+            (necap = stroke_pie_cap_points(ecap, &plp->e)) < 0)
+            return 1;
+    } else if (nplp->thin) {
+        /* No join. */
+    } else if (join == gs_join_round) {
+        double l = (double)plp->width.x * nplp->width.y;
+        double r = (double)nplp->width.x * plp->width.y;
+
+        if (l == r) {
+            if ((njoin = stroke_pie_cap_points(join_pts, &plp->e)) < 0)
+                return 1;
+        } else {
+            const gs_fixed_point *cur, *fin, *tan;
+            gs_fixed_point u, f;
+            double det, a;
+
+            if ((l > r) ^ reflected)
+                cur = &plp->e.co, fin = &nplp->o.ce, tan = &plp->e.cdelta;
+            else
+                cur = &nplp->o.co, fin = &plp->e.ce, tan = &nplp->o.cdelta;
+            if (cur->x != fin->x || cur->y != fin->y) {
+                /* Find the angle of the pie, in the ellipse's own terms. */
+                u.x = cur->x - plp->e.p.x, u.y = cur->y - plp->e.p.y;
+                f.x = fin->x - plp->e.p.x, f.y = fin->y - plp->e.p.y;
+                det = (double)u.x * tan->y - (double)u.y * tan->x;
+                if (det == 0)
+                    return 1;
+                a = atan2(((double)u.x * f.y - (double)u.y * f.x) / det,
+                          ((double)f.x * tan->y - (double)f.y * tan->x) / det);
+                if (a <= 0)
+                    return 1;
+                join_pts[0] = plp->e.p;
+                if ((njoin = stroke_arc_points(join_pts + 1, &plp->e.p, &u,
+                                               tan, a)) < 0)
+                    return 1;
+                njoin++;
+            }
+        }
+    } else if (join == gs_join_bevel || join == gs_join_miter ||
+               join == gs_join_none) {
+        gs_fixed_point jp[5];
+        bool ccw = ((double)plp->width.x * nplp->width.y >
+                    (double)nplp->width.x * plp->width.y) ^ reflected;
+
+        /* line_join_points gives the outline from plp->e.co to */
+        /* plp->e.ce, with the miter point, if any, at the outside. */
+        code = line_join_points(pgs_lp, plp, nplp, jp,
+                                (uniform ? (gs_matrix *) 0 : &ctm_only(pgs)),
+                                join, reflected);
+        if (code != 4)
+            return 1;
+        join_pts[0] = nplp->o.p;
+        if (ccw) {
+            join_pts[1] = plp->e.co;
+            join_pts[2] = jp[0];
+            join_pts[3] = nplp->o.ce;
+        } else {
+            join_pts[1] = nplp->o.co;
+            join_pts[2] = jp[3];
+            join_pts[3] = plp->e.ce;
+        }
+        njoin = 4;
+    } else
+        return 1;
+
+#define PIECE_IN_RANGE(pts, n)\
+    for (i = 0; i < n; i++)\
+        if (any_abs(pts[i].x) > STROKE_PIECE_MAX_COORD ||\
+            any_abs(pts[i].y) > STROKE_PIECE_MAX_COORD)\
+            return 1
+    PIECE_IN_RANGE(body, 4);
+    PIECE_IN_RANGE(join_pts, njoin);
+    PIECE_IN_RANGE(scap, nscap);
+    PIECE_IN_RANGE(ecap, necap);
+#undef PIECE_IN_RANGE
+
+    code = stroke_fill_convex(dev, body, 4, adjust, pdevc, pgs->log_op);
+    if (code >= 0 && njoin)
+        code = stroke_fill_convex(dev, join_pts, njoin, adjust, pdevc,
+                                  pgs->log_op);
+    if (code >= 0 && nscap)
+        code = stroke_fill_convex(dev, scap, nscap, adjust, pdevc,
+                                  pgs->log_op);
+    if (code >= 0 && necap)
+        code = stroke_fill_convex(dev, ecap, necap, adjust, pdevc,
+                                  pgs->log_op);
+    return code;
+}
+
 /* Draw a line on the device. */
 /* Treat no join the same as a bevel join. */
 /* rpath should always be NULL, hence ensure_closed can be ignored */
@@ -1426,11 +1801,47 @@ stroke_fill(gx_path * ppath, gx_path * rpath, bool ensure_closed, int first,
                                  pgs_lp->dash_cap : pgs_lp->start_cap);
         gs_line_cap end_cap   = (flags & nf_dash_tail ?
                                  pgs_lp->dash_cap : pgs_lp->end_cap);
+        /*
+         * We only know how to paint pieces of a stroke the same way as
+         * the scan converter for the 'center of pixel' and 'any part of
+         * pixel' rules (see gs_rectfill), so leave other fill
+         * adjustments to the general code.
+         */
+        fixed adjust_x = STROKE_ADJUSTMENT(false, pgs, x);
+        fixed adjust_y = STROKE_ADJUSTMENT(false, pgs, y);
+        bool direct = (adjust_x == adjust_y &&
+                       (adjust_x == 0 || adjust_x == fixed_half));
 
         if (first != 0)
             start_cap = gs_cap_butt;
         if (nplp != 0)
             end_cap = gs_cap_butt;
+        {
+            /* Axis-aligned segments go straight to fill_rectangle. */
+            gs_fixed_rect r;
+
+            if (direct &&
+                stroke_axis_aligned_rect(pgs_lp, plp, nplp, start_cap,
+                                         end_cap, join, &r)) {
+                int x0, y0, x1, y1;
+
+                if (adjust_x == 0) {
+                    x0 = fixed2int(fixed_rounded(r.p.x));
+                    y0 = fixed2int(fixed_rounded(r.p.y));
+                    x1 = fixed2int(fixed_rounded(r.q.x));
+                    y1 = fixed2int(fixed_rounded(r.q.y));
+                } else {
+                    x0 = fixed2int(fixed_floor(r.p.x));
+                    y0 = fixed2int(fixed_floor(r.p.y));
+                    x1 = fixed2int(fixed_ceiling(r.q.x));
+                    y1 = fixed2int(fixed_ceiling(r.q.y));
+                }
+                if (x1 <= x0 || y1 <= y0)
+                    return 0;
+                return gx_fill_rectangle_device_rop(x0, y0, x1 - x0, y1 - y0,
+                                                    pdevc, dev, pgs->log_op);
+            }
+        }
         if (!plp->thin && (nplp == 0 || !nplp->thin)
             && (start_cap == gs_cap_butt || start_cap == gs_cap_square)
             && (end_cap   == gs_cap_butt || end_cap   == gs_cap_square)
@@ -1499,6 +1910,15 @@ stroke_fill(gx_path * ppath, gx_path * rpath, bool ensure_closed, int first,
                 return code;
             return gx_path_close_subpath(ppath);
         }
+        /* Other segments of polylines go straight to fill_trapezoid. */
+        if (direct && !(flags & (nf_all_from_arc | nf_some_from_arc))) {
+            int code = stroke_fill_pieces(plp, nplp, start_cap, end_cap,
+                                          join, uniform, reflected,
+                                          adjust_x, dev, pgs, pdevc);
+
+            if (code != 1)
+                return code;
+        }
     }
     /* General case: construct a path for the fill algorithm. */
  general:
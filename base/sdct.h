@@ -138,6 +138,10 @@ typedef struct stream_DCT_state_s {
      * DCTDecode cannot set it until the JPEG headers are read.
      */
     uint scan_line_size;
+    /* DCTDecode only: a client that knows the image will be rendered */
+    /* at reduced resolution may set these before the first read. */
+    int scale_denom;		/* decode at 1/scale_denom size (1, 2, 4, 8) */
+    bool header_only;		/* stop once the headers have been read */
     /* The following are updated dynamically. */
     int phase;
 } stream_DCT_state;
@@ -106,6 +106,8 @@ s_DCTD_init(stream_state * st)
     ss->data.decompress->skip = 0;
     ss->data.decompress->input_eod = false;
     ss->data.decompress->faked_eoi = false;
+    ss->scale_denom = 1;
+    ss->header_only = false;
     ss->phase = 0;
     return 0;
 }
@@ -281,6 +283,21 @@ s_DCTD_process(stream_state * st, stream_cursor_read * pr,
             ss->phase = 2;
             /* falls through */
         case 2:		/* start_decompress */
+            if (ss->header_only)
+                return 1;
+            if (ss->scale_denom > 1) {
+                /* Let the IDCT produce a reduced image directly. */
+                jddp->dinfo.scale_num = 1;
+                jddp->dinfo.scale_denom = ss->scale_denom;
+            } else {
+                /*
+                 * With IDCT scaling compiled in (see gsjmorec.h), "fancy"
+                 * upsampling makes the IDCT upsample subsampled chroma.
+                 * At full size, keep to the plain upsampling we had
+                 * without it, so the output doesn't change.
+                 */
+                jddp->dinfo.do_fancy_upsampling = FALSE;
+            }
             if ((code = gs_jpeg_start_decompress(ss)) < 0)
                 return ERRC;
             pr->ptr =
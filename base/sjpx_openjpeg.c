@@ -31,6 +31,9 @@
  * in the openjpeg library. */
 #if !defined(SHARE_JPX) || (SHARE_JPX == 0)
 static gs_memory_t *opj_memory;
+/* The worker threads of a codec can allocate whenever they like, so
+ * opj_memory stays set while any codec exists. */
+static int opj_codecs;
 #endif
 
 int sjpxd_create(gs_memory_t *mem)
@@ -71,8 +74,8 @@ static int opj_lock(gs_memory_t *mem)
 
     ret = gx_monitor_enter((gx_monitor_t *)ctx->sjpxd_private);
 #endif
-    assert(opj_memory == NULL);
-    opj_memory = mem->non_gc_memory;
+    assert(opj_memory == NULL || opj_memory == mem->non_gc_memory->thread_safe_memory);
+    opj_memory = mem->non_gc_memory->thread_safe_memory;
     return ret;
 #else
     return 0;
@@ -85,7 +88,8 @@ static int opj_unlock(gs_memory_t *mem)
     gs_lib_ctx_t *ctx = mem->gs_lib_ctx;
 
     assert(opj_memory != NULL);
-    opj_memory = NULL;
+    if (opj_codecs == 0)
+        opj_memory = NULL;
 #ifdef MEMENTO_SQUEEZE_BUILD
     (void)ctx;
     return 0;
@@ -98,18 +102,35 @@ static int opj_unlock(gs_memory_t *mem)
 }
 
 #if !defined(SHARE_JPX) || (SHARE_JPX == 0)
-/* Allocation routines that use the memory pointer given above */
+/* Allocation routines that use the memory pointer given above, which
+ * is a thread safe allocator, since OpenJPEG's worker threads use these
+ * too, without taking our lock.  Each block records the allocator it came
+ * from, so that freeing and resizing don't depend on opj_memory.
+ */
+typedef union {
+    gs_memory_t *mem;
+    double align[2];		/* keep the block suitably aligned */
+} opj_block_header;
+
 void *opj_malloc(size_t size)
 {
+    gs_memory_t *mem;
+    opj_block_header *hdr;
+
     if (size == 0)
         return NULL;
 
     assert(opj_memory != NULL);
 
-    if (size > (size_t) ARCH_MAX_UINT)
+    if (size > (size_t) ARCH_MAX_UINT - sizeof(opj_block_header))
 	    return NULL;
 
-    return (void *)gs_alloc_bytes(opj_memory, size, "opj_malloc");
+    mem = opj_memory;
+    hdr = (opj_block_header *)gs_alloc_bytes(mem, size + sizeof(opj_block_header), "opj_malloc");
+    if (hdr == NULL)
+        return NULL;
+    hdr->mem = mem;
+    return hdr + 1;
 }
 
 void *opj_calloc(size_t n, size_t size)
@@ -127,6 +148,8 @@ void *opj_calloc(size_t n, size_t size)
 
 void *opj_realloc(void *ptr, size_t size)
 {
+    opj_block_header *hdr;
+
     if (ptr == NULL)
         return opj_malloc(size);
 
@@ -136,12 +159,23 @@ void *opj_realloc(void *ptr, size_t size)
         return NULL;
     }
 
-    return gs_resize_object(opj_memory, ptr, size, "opj_malloc");
+    if (size > (size_t) ARCH_MAX_UINT - sizeof(opj_block_header))
+	    return NULL;
+
+    hdr = (opj_block_header *)ptr - 1;
+    hdr = gs_resize_object(hdr->mem, hdr, size + sizeof(opj_block_header), "opj_malloc");
+    return (hdr == NULL ? NULL : hdr + 1);
 }
 
 void opj_free(void *ptr)
 {
-    gs_free_object(opj_memory, ptr, "opj_malloc");
+    opj_block_header *hdr;
+
+    if (ptr == NULL)
+        return;
+
+    hdr = (opj_block_header *)ptr - 1;
+    gs_free_object(hdr->mem, hdr, "opj_malloc");
 }
 
 static inline void * opj_aligned_malloc_n(size_t size, size_t align)
@@ -269,6 +303,7 @@ s_opjd_init(stream_state * ss)
     state->sign_comps = NULL;
     state->stream = NULL;
     state->row_data = NULL;
+    state->header_only = false;
 
     return 0;
 }
@@ -290,12 +325,21 @@ s_opjd_set_codec_format(stream_state * ss, OPJ_CODEC_FORMAT format)
     state->codec = opj_create_decompress(format);
     if (state->codec == NULL)
         return_error(gs_error_VMerror);
+#if !defined(SHARE_JPX) || (SHARE_JPX == 0)
+    opj_codecs++;
+#endif
 
     /* catch events using our callbacks */
     opj_set_error_handler(state->codec, sjpx_error_callback, stderr);
     opj_set_info_handler(state->codec, sjpx_info_callback, stderr);
     opj_set_warning_handler(state->codec, sjpx_warning_callback, stderr);
 
+#if OPJ_VERSION_MAJOR > 2 || (OPJ_VERSION_MAJOR == 2 && OPJ_VERSION_MINOR >= 2)
+    /* decode code-blocks on all the available processors */
+    if (opj_has_thread_support() && opj_get_num_cpus() > 1)
+        (void)opj_codec_set_threads(state->codec, opj_get_num_cpus());
+#endif
+
     if (state->colorspace == gs_jpx_cs_indexed) {
         parameters.flags |= OPJ_DPARAMETERS_IGNORE_PCLR_CMAP_CDEF_FLAG;
     }
@@ -395,16 +439,26 @@ ycc_to_rgb_16(unsigned char *row, unsigned long row_size)
     while (row_size);
 }
 
-static int decode_image(stream_jpxd_state * const state)
+static int read_header(stream_jpxd_state * const state)
 {
-    int numprimcomp = 0, alpha_comp = -1, compno, rowbytes;
+#if OPJ_VERSION_MAJOR >= 2 && OPJ_VERSION_MINOR >= 1
+    opj_stream_set_user_data(state->stream, &(state->sb), NULL);
+#else
+    opj_stream_set_user_data(state->stream, &(state->sb));
+#endif
+    opj_stream_set_user_data_length(state->stream, state->sb.size);
 
-    /* read header */
     if (!opj_read_header(state->stream, state->codec, &(state->image)))
     {
     	dlprintf("openjpeg: failed to read header\n");
     	return ERRC;
     }
+    return 0;
+}
+
+static int decode_image(stream_jpxd_state * const state)
+{
+    int numprimcomp = 0, alpha_comp = -1, compno, rowbytes;
 
     /* decode the stream and fill the image structure */
     if (!opj_decode(state->codec, state->stream, state->image))
@@ -687,79 +741,147 @@ s_opjd_process(stream_state * ss, stream_cursor_read * pr,
 {
     stream_jpxd_state *const state = (stream_jpxd_state *) ss;
     long in_size = pr->limit - pr->ptr;
-    int locked = 0;
     int code;
 
     if (in_size > 0) 
     {
         /* buffer available data */
-        code = opj_lock(ss->memory);
-        if (code < 0) return code;
-        locked = 1;
-
         code = s_opjd_accumulate_input(state, pr);
         if (code < 0) return code;
 
         if (state->codec == NULL) {
+            code = opj_lock(ss->memory);
+            if (code < 0) return code;
             /* state->sb.size is non-zero after successful
                accumulate_input(); 1 is probably extremely rare */
             if (state->sb.data[0] == 0xFF && ((state->sb.size == 1) || (state->sb.data[1] == 0x4F)))
                 code = s_opjd_set_codec_format(ss, OPJ_CODEC_J2K);
             else
                 code = s_opjd_set_codec_format(ss, OPJ_CODEC_JP2);
+            (void)opj_unlock(ss->memory);
             if (code < 0)
-            {
-                (void)opj_unlock(ss->memory);
                 return code;
-            }
         }
     }
 
     if (last == 1) 
     {
-        if (state->image == NULL)
+        if (state->image == NULL || (state->pdata == NULL && !state->header_only))
         {
             int ret;
 
-            if (locked == 0)
-            {
-                ret = opj_lock(ss->memory);
-                if (ret < 0) return ret;
-                locked = 1;
-            }
-
-#if OPJ_VERSION_MAJOR >= 2 && OPJ_VERSION_MINOR >= 1
-            opj_stream_set_user_data(state->stream, &(state->sb), NULL);
-#else
-            opj_stream_set_user_data(state->stream, &(state->sb));
-#endif
-            opj_stream_set_user_data_length(state->stream, state->sb.size);
-            ret = decode_image(state);
+            ret = opj_lock(ss->memory);
+            if (ret < 0) return ret;
+            if (state->image == NULL)
+                ret = read_header(state);
+            if (ret == 0 && !state->header_only)
+                ret = decode_image(state);
+            (void)opj_unlock(ss->memory);
             if (ret != 0)
-            {
-                (void)opj_unlock(ss->memory);
                 return ret;
-            }
         }
 
-        if (locked)
-        {
-            code = opj_unlock(ss->memory);
-            if (code < 0) return code;
-        }
+        /* see s_jpxd_reduce */
+        if (state->header_only)
+            return 1;
 
         /* copy out available data */
         return process_one_trunk(state, pw);
 
     }
 
-    if (locked)
-        return opj_unlock(ss->memory);
-
     /* ask for more data */
     return 0;
 }
 
+/* Look for a palette box in the header of a JP2 file.  The codestream of
+   such a file holds palette indices, which can't be decoded at reduced
+   resolution.  A header we can't parse counts as having a palette. */
+static bool
+jp2_has_palette(const byte *data, unsigned long size)
+{
+    unsigned long pos = 0, end = size;
+
+    if (size >= 2 && data[0] == 0xFF && data[1] == 0x4F)
+        return false;	/* bare codestream */
+    while (pos + 8 <= end) {
+        unsigned long len = ((unsigned long)data[pos] << 24) |
+            (data[pos + 1] << 16) | (data[pos + 2] << 8) | data[pos + 3];
+        const byte *type = data + pos + 4;
+
+        if (len == 0)
+            len = end - pos;
+        if (len < 8 || len > end - pos)
+            return true;
+        if (!memcmp(type, "jp2h", 4)) {
+            /* look inside the JP2 header box only */
+            end = pos + len;
+            pos += 8;
+            continue;
+        }
+        if (!memcmp(type, "pclr", 4))
+            return true;
+        if (!memcmp(type, "jp2c", 4))
+            break;
+        pos += len;
+    }
+    return false;
+}
+
+/* Decode the image at reduced resolution, discarding up to log2(max_factor)
+   resolution levels, if the headers have been read (see header_only) and
+   the image is width x height.  Return the reduction factor, and the size
+   of the reduced image in *pwidth, *pheight. */
+int
+s_jpxd_reduce(stream_jpxd_state *state, int width, int height,
+              int max_factor, int *pwidth, int *pheight)
+{
+    opj_image_t *image = state->image;
+    opj_codestream_info_v2_t *info;
+    int compno, reduce = 0;
+
+    if (image == NULL || state->pdata != NULL || image->numcomps == 0 ||
+        state->colorspace == gs_jpx_cs_indexed ||
+        (int)(image->x1 - image->x0) != width ||
+        (int)(image->y1 - image->y0) != height)
+        return 1;
+    for (compno = 0; compno < image->numcomps; compno++)
+        if (image->comps[compno].dx != 1 || image->comps[compno].dy != 1)
+            return 1;
+    if (jp2_has_palette(state->sb.data, state->sb.fill))
+        return 1;
+
+    while ((2 << reduce) <= max_factor)
+        reduce++;
+    if (opj_lock(state->memory) < 0)
+        return 1;
+    /* Each component must keep at least its lowest resolution level. */
+    info = opj_get_cstr_info(state->codec);
+    if (info == NULL)
+        reduce = 0;
+    else {
+        for (compno = 0; compno < info->nbcomps; compno++) {
+            int numres = info->m_default_tile_info.tccp_info[compno].numresolutions;
+
+            if (reduce > numres - 1)
+                reduce = numres - 1;
+        }
+        opj_destroy_cstr_info(&info);
+    }
+    if (reduce > 0 && !opj_set_decoded_resolution_factor(state->codec, reduce))
+        reduce = 0;
+    (void)opj_unlock(state->memory);
+    if (reduce == 0)
+        return 1;
+
+    /* This is how the library computes the size of a reduced component. */
+    *pwidth = (int)((((OPJ_INT64)image->x1 + (1 << reduce) - 1) >> reduce) -
+                    (((OPJ_INT64)image->x0 + (1 << reduce) - 1) >> reduce));
+    *pheight = (int)((((OPJ_INT64)image->y1 + (1 << reduce) - 1) >> reduce) -
+                     (((OPJ_INT64)image->y0 + (1 << reduce) - 1) >> reduce));
+    return 1 << reduce;
+}
+
 /* Set the defaults */
 static void
 s_opjd_set_defaults(stream_state * ss) {
@@ -794,6 +916,9 @@ s_opjd_release(stream_state *ss)
     /* free decoder handle */
     if (state->codec)
 	opj_destroy_codec(state->codec);
+#if !defined(SHARE_JPX) || (SHARE_JPX == 0)
+    opj_codecs--;
+#endif
 
     (void)opj_unlock(ss->memory);
 
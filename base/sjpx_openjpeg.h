@@ -68,8 +68,15 @@ typedef struct stream_jpxd_state_s
     int *sign_comps; /* compensate for signed data (signed => unsigned) */
 
     unsigned char *row_data;
+
+    bool header_only; /* stop once the headers have been read */
 } stream_jpxd_state;
 
 extern const stream_template s_jpxd_template;
 
+/* Decode at reduced resolution after reading the headers with
+   header_only set, see sjpx_openjpeg.c. */
+int s_jpxd_reduce(stream_jpxd_state *state, int width, int height,
+                  int max_factor, int *pwidth, int *pheight);
+
 #endif 